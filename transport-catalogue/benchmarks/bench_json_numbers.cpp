@@ -0,0 +1,117 @@
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "json.h"
+#include "json_writer.h"
+#include "log_duration.h"
+
+using namespace std::literals;
+
+namespace {
+
+// считает числа из событий потокового разбора
+class CountingHandler : public json::Handler {
+public:
+    size_t count = 0;
+    double sum = 0;
+
+    void Null() override {}
+    void Bool(bool) override {}
+    void Int(int value) override {
+        ++count;
+        sum += value;
+    }
+    void Double(double value) override {
+        ++count;
+        sum += value;
+    }
+    void String(std::string) override {}
+    void StartArray() override {}
+    void EndArray() override {}
+    void StartDict() override {}
+    void Key(std::string) override {}
+    void EndDict() override {}
+};
+
+// числа как во входных данных справочника: координаты, расстояния и скорости
+std::vector<json::Node::Value> MakeNumbers(size_t count) {
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> coordinate(-90, 90);
+    std::uniform_int_distribution<int> distance(1, 1'000'000);
+    std::vector<json::Node::Value> numbers;
+    numbers.reserve(count);
+    for(size_t i = 0; i < count; ++i) {
+        if(i % 2 == 0) {
+            numbers.emplace_back(coordinate(generator));
+        } else {
+            numbers.emplace_back(distance(generator));
+        }
+    }
+    return numbers;
+}
+
+}  // namespace
+
+// Замеряет разбор и вывод массива чисел модулем json и для сравнения - потоками и strtod:
+// ./bench_json_numbers [число чисел]
+int main(int argc, char* argv[]) {
+    const size_t count = argc > 1 ? std::stoul(argv[1]) : 2'000'000;
+    const auto numbers = MakeNumbers(count);
+
+    std::string text;
+    {
+        LOG_DURATION("json::Writer print"s);
+        std::ostringstream output;
+        json::Writer writer(output);
+        writer.StartArray();
+        for(const auto& number : numbers) {
+            writer.Value(number);
+        }
+        writer.EndArray();
+        writer.Flush();
+        text = output.str();
+    }
+    {
+        LOG_DURATION("ostream print (precision 17)"s);
+        std::ostringstream output;
+        output << std::setprecision(17);
+        for(const auto& number : numbers) {
+            std::visit([&output](const auto& value) {
+                if constexpr(std::is_arithmetic_v<std::decay_t<decltype(value)>>) {
+                    output << value << ", "sv;
+                }
+            }, number);
+        }
+    }
+
+    // результаты накапливаются, чтобы компилятор не выбросил циклы
+    double sum = 0;
+    {
+        LOG_DURATION("json::Load from buffer"s);
+        const json::Document document = json::Load(std::string_view(text));
+        for(const json::Node& node : document.GetRoot().AsArray()) {
+            sum += node.AsDouble();
+        }
+    }
+    {
+        LOG_DURATION("json::Parse from stream"s);
+        std::istringstream input(text);
+        CountingHandler handler;
+        json::Parse(input, handler);
+        sum += handler.sum;
+    }
+    {
+        LOG_DURATION("strtod over the same text"s);
+        const char* pos = text.data() + 1;
+        char* end = nullptr;
+        for(size_t i = 0; i < count; ++i, pos = end + 1) {
+            sum += std::strtod(pos, &end);
+        }
+    }
+    std::cerr << "numbers: "sv << count << ", text: "sv << (text.size() >> 10) << " KB, sum: "sv << sum << '\n';
+}
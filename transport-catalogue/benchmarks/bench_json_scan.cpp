@@ -0,0 +1,76 @@
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "json_scan.h"
+#include "log_duration.h"
+
+using namespace json::scan;
+using namespace std::literals;
+
+namespace {
+
+using FindFunc = const char* (*)(const char*, const char*, Kernel);
+
+// буфер из заполнителя, в котором искомый символ special встречается в среднем раз в period байт
+std::string MakeBuffer(size_t size, char filler, char special, size_t period) {
+    std::string buffer(size, filler);
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<size_t> gap(1, 2 * period - 1);
+    for(size_t pos = gap(generator); pos < size; pos += gap(generator)) {
+        buffer[pos] = special;
+    }
+    return buffer;
+}
+
+// проходит буфер от символа к символу, как разбор JSON; возвращает число найденных символов
+size_t ScanAll(FindFunc func, const std::string& buffer, Kernel kernel) {
+    const char* pos = buffer.data();
+    const char* end = pos + buffer.size();
+    size_t found = 0;
+    while((pos = func(pos, end, kernel)) != end) {
+        ++found;
+        ++pos;
+    }
+    return found;
+}
+
+}  // namespace
+
+// Сравнивает ядра поиска json::scan на буферах с разной плотностью искомых символов:
+// ./bench_json_scan [размер буфера в МБ]
+int main(int argc, char* argv[]) {
+    const size_t size = (argc > 1 ? std::stoul(argv[1]) : 64) << 20;
+
+    struct Search {
+        std::string name;
+        FindFunc func;
+        char filler;
+        char special;
+    };
+    const std::vector<Search> searches = {
+        {"FindStringSpecial"s, FindStringSpecial, 'a', '"'},
+        {"SkipSpaces"s, SkipSpaces, ' ', '{'},
+        {"FindEscaped"s, FindEscaped, 'a', '\t'},
+    };
+    const std::vector<std::pair<std::string, Kernel>> kernels = {
+        {"scalar"s, Kernel::SCALAR}, {"sse2"s, Kernel::SSE2}, {"avx2"s, Kernel::AVX2}};
+
+    // результаты накапливаются, чтобы компилятор не выбросил циклы
+    size_t found = 0;
+    for(const Search& search : searches) {
+        for(size_t period : {8, 64, 1024}) {
+            const std::string buffer = MakeBuffer(size, search.filler, search.special, period);
+            for(const auto& [kernel_name, kernel] : kernels) {
+                if(!IsSupported(kernel)) {
+                    std::cerr << search.name << ' ' << kernel_name << ": not supported\n"sv;
+                    continue;
+                }
+                LOG_DURATION(search.name + ", period "s + std::to_string(period) + ", "s + kernel_name);
+                found += ScanAll(search.func, buffer, kernel);
+            }
+        }
+    }
+    std::cerr << "buffer: "sv << (size >> 20) << " MB, found: "sv << found << '\n';
+}
@@ -0,0 +1,92 @@
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "log_duration.h"
+#include "memory_usage.h"
+#include "perfect_hash.h"
+#include "transport_catalogue.h"
+
+using namespace catalogue;
+using namespace std::literals;
+
+namespace {
+
+std::string MakeName(size_t i) {
+    return "Остановка "s.append(std::to_string(i * 2654435761ULL % 1'000'000'007));
+}
+
+// ищет каждое название запроса; возвращает число найденных
+size_t FindAll(const TransportCatalogue& catalogue, const std::vector<std::string>& queries) {
+    size_t found = 0;
+    for(const std::string& name : queries) {
+        found += catalogue.GetStop(name) != nullptr;
+    }
+    return found;
+}
+
+}  // namespace
+
+// Сравнивает поиск остановок справочника по названию до заморозки (std::unordered_map)
+// и после неё (PerfectHashFunction и ячейки by_slot), а также построение и объём обоих индексов:
+// ./bench_perfect_hash [число остановок]
+int main(int argc, char* argv[]) {
+    const size_t count = argc > 1 ? std::stoul(argv[1]) : 2'000'000;
+
+    std::vector<std::string> names;
+    names.reserve(count);
+    std::vector<Stop> stops;
+    stops.reserve(count);
+    for(size_t i = 0; i < count; ++i) {
+        names.push_back(MakeName(i));
+    }
+    for(const std::string& name : names) {
+        stops.push_back(Stop{name, geo::Coordinates{55.7, 37.6}});
+    }
+    // запросы в случайном порядке, половина - названия, которых нет в справочнике
+    std::vector<std::string> queries = names;
+    for(size_t i = 0; i < count; ++i) {
+        queries.push_back(MakeName(count + i));
+    }
+    std::shuffle(queries.begin(), queries.end(), std::mt19937(42));
+
+    TransportCatalogue catalogue;
+    catalogue.AddBulk(stops, {}, {});
+
+    // результаты накапливаются, чтобы компилятор не выбросил циклы
+    size_t found = 0;
+    {
+        LOG_DURATION("unordered_map GetStop"s);
+        found += FindAll(catalogue, queries);
+    }
+    catalogue.Freeze();
+    {
+        LOG_DURATION("perfect hash GetStop"s);
+        found += FindAll(catalogue, queries);
+    }
+
+    // построение отдельно от остальных индексов заморозки
+    const std::vector<std::string_view> keys(names.begin(), names.end());
+    std::unordered_map<std::string_view, const Stop*> hash_table;
+    {
+        LOG_DURATION("unordered_map build"s);
+        for(StopId id = 0; id < count; ++id) {
+            hash_table[keys[id]] = catalogue.GetStopById(id);
+        }
+    }
+    {
+        LOG_DURATION("PerfectHashFunction build"s);
+        found += PerfectHashFunction(keys).GetSize();
+    }
+
+    const FrozenIndexes indexes = catalogue.GetFrozenIndexes();
+    const size_t perfect_memory = indexes.stops_hash.pilots.size_bytes() + indexes.stops_hash.remap.size_bytes()
+                                  + indexes.stops_by_slot.size_bytes();
+    std::cerr << "stops: "sv << count << ", found: "sv << found
+              << "\nunordered_map memory: "sv << (memory::GetUsage(hash_table) >> 10)
+              << " KB\nperfect hash with by_slot memory: "sv << (perfect_memory >> 10) << " KB\n"sv;
+}
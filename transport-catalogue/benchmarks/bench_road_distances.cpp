@@ -0,0 +1,130 @@
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "log_duration.h"
+#include "memory_usage.h"
+#include "road_distances.h"
+
+using namespace catalogue;
+using namespace std::literals;
+
+namespace {
+
+struct Segment {
+    domain::StopId from;
+    domain::StopId to;
+    uint32_t distance;
+};
+
+// хеш пары остановок, как в прежнем хранилище расстояний
+struct StopPairHasher {
+    size_t operator()(std::pair<domain::StopId, domain::StopId> value) const noexcept {
+        return static_cast<size_t>((static_cast<uint64_t>(value.first) << 32) | value.second);
+    }
+};
+
+using DistanceTable = std::unordered_map<std::pair<domain::StopId, domain::StopId>, size_t, StopPairHasher>;
+
+// прежний поиск: сначала в заданном направлении, затем в обратном
+size_t FindInTable(const DistanceTable& table, domain::StopId from, domain::StopId to) {
+    if(auto iter = table.find({from, to}); iter != table.end()) {
+        return iter->second;
+    }
+    if(auto iter = table.find({to, from}); iter != table.end()) {
+        return iter->second;
+    }
+    return 0;
+}
+
+// отрезки между соседними по номеру остановками, в среднем четыре отрезка на остановку
+std::vector<Segment> MakeSegments(size_t count) {
+    const auto stops_count = static_cast<domain::StopId>(count / 4 + 1);
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<domain::StopId> stop(0, stops_count - 1);
+    std::uniform_int_distribution<domain::StopId> offset(1, 64);
+    std::uniform_int_distribution<uint32_t> distance(100, 5000);
+    std::vector<Segment> segments(count);
+    for(Segment& segment : segments) {
+        segment.from = stop(generator);
+        segment.to = (segment.from + offset(generator)) % stops_count;
+        segment.distance = distance(generator);
+    }
+    return segments;
+}
+
+// случайные отрезки из заданных, половина - в обратном направлении
+std::vector<std::pair<domain::StopId, domain::StopId>> MakeQueries(const std::vector<Segment>& segments,
+                                                                   size_t count) {
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<size_t> index(0, segments.size() - 1);
+    std::vector<std::pair<domain::StopId, domain::StopId>> queries(count);
+    for(size_t i = 0; i < count; ++i) {
+        const Segment& segment = segments[index(generator)];
+        queries[i] = i % 2 == 0 ? std::pair{segment.from, segment.to} : std::pair{segment.to, segment.from};
+    }
+    return queries;
+}
+
+}  // namespace
+
+// Сравнивает построение, поиск и объём памяти RoadDistances (строки смежности, упакованные в CSR)
+// с прежней хеш-таблицей по паре остановок: ./bench_road_distances [число отрезков] [число запросов]
+int main(int argc, char* argv[]) {
+    const size_t count = argc > 1 ? std::stoul(argv[1]) : 50'000'000;
+    const size_t queries_count = argc > 2 ? std::stoul(argv[2]) : 10'000'000;
+    const auto segments = MakeSegments(count);
+    const auto queries = MakeQueries(segments, queries_count);
+
+    // результаты накапливаются, чтобы компилятор не выбросил циклы;
+    // хранилища строятся по очереди, чтобы не держать в памяти оба сразу
+    size_t sum = 0;
+    {
+        DistanceTable table;
+        {
+            LOG_DURATION("unordered_map build"s);
+            for(const Segment& segment : segments) {
+                table[{segment.from, segment.to}] = segment.distance;
+            }
+        }
+        {
+            LOG_DURATION("unordered_map find"s);
+            for(const auto& [from, to] : queries) {
+                sum += FindInTable(table, from, to);
+            }
+        }
+        std::cerr << "unordered_map memory: "sv << (memory::GetUsage(table) >> 20) << " MB\n"sv;
+    }
+    {
+        RoadDistances distances;
+        {
+            LOG_DURATION("RoadDistances build"s);
+            for(const Segment& segment : segments) {
+                distances.Add(segment.from, segment.to, segment.distance);
+            }
+        }
+        std::cerr << "RoadDistances rows memory: "sv << (distances.GetMemoryUsage() >> 20) << " MB\n"sv;
+        {
+            LOG_DURATION("RoadDistances rows find"s);
+            for(const auto& [from, to] : queries) {
+                sum += distances.Find(from, to).value_or(0);
+            }
+        }
+        {
+            LOG_DURATION("RoadDistances compact"s);
+            distances.Compact();
+        }
+        {
+            LOG_DURATION("RoadDistances CSR find"s);
+            for(const auto& [from, to] : queries) {
+                sum += distances.Find(from, to).value_or(0);
+            }
+        }
+        std::cerr << "RoadDistances CSR memory: "sv << (distances.GetMemoryUsage() >> 20) << " MB\n"sv;
+    }
+    std::cerr << "segments: "sv << count << ", queries: "sv << queries_count << ", sum: "sv << sum << '\n';
+}
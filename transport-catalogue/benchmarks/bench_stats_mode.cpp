@@ -0,0 +1,98 @@
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "log_duration.h"
+#include "transport_catalogue.h"
+
+using namespace catalogue;
+using namespace std::literals;
+
+namespace {
+
+const size_t STOPS_PER_BUS = 50;
+
+struct Network {
+    std::vector<std::string> stop_names;
+    std::vector<std::string> bus_names;
+    std::vector<Stop> stops;
+    std::vector<DistanceDescription> distances;
+    std::vector<BusDescription> buses;
+};
+
+// сеть из buses_count маршрутов, каждый проходит STOPS_PER_BUS остановок подряд по соседним номерам
+Network MakeNetwork(size_t buses_count) {
+    const size_t stops_count = buses_count * 2;
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> lat(55.5, 55.9);
+    std::uniform_real_distribution<double> lng(37.3, 37.9);
+    std::uniform_int_distribution<size_t> first_stop(0, stops_count - 1);
+    std::uniform_int_distribution<size_t> step(1, 4);
+    std::uniform_int_distribution<size_t> distance(100, 5000);
+
+    Network network;
+    network.stop_names.reserve(stops_count);
+    for(size_t i = 0; i < stops_count; ++i) {
+        network.stop_names.push_back("Остановка "s.append(std::to_string(i)));
+    }
+    for(size_t i = 0; i < stops_count; ++i) {
+        network.stops.push_back(Stop{network.stop_names[i], geo::Coordinates{lat(generator), lng(generator)}});
+    }
+    network.bus_names.reserve(buses_count);
+    for(size_t i = 0; i < buses_count; ++i) {
+        network.bus_names.push_back("Маршрут "s.append(std::to_string(i)));
+        BusDescription bus{network.bus_names.back(), {}, i % 2 == 0};
+        size_t stop = first_stop(generator);
+        for(size_t j = 0; j < STOPS_PER_BUS; ++j) {
+            const size_t next = (stop + step(generator)) % stops_count;
+            bus.stops.push_back(network.stop_names[stop]);
+            network.distances.push_back({network.stop_names[stop], network.stop_names[next], distance(generator)});
+            stop = next;
+        }
+        if(bus.is_roundtrip) {
+            bus.stops.push_back(bus.stops.front());
+        }
+        network.buses.push_back(std::move(bus));
+    }
+    return network;
+}
+
+// загружает сеть и запрашивает статистику каждого маршрута с шагом stride;
+// возвращает сумму длин, чтобы компилятор не выбросил расчёт
+size_t Measure(const Network& network, StatsMode stats_mode, std::string_view mode_name, size_t stride) {
+    std::string name(mode_name);
+    name.append(", every "sv).append(std::to_string(stride)).append(" bus queried: "sv);
+    TransportCatalogue catalogue(stats_mode);
+    {
+        LOG_DURATION(name + "AddBulk"s);
+        catalogue.AddBulk(network.stops, network.distances, network.buses);
+    }
+    size_t length = 0;
+    {
+        LOG_DURATION(name + "GetRouteInfo"s);
+        for(BusId bus = 0; bus < catalogue.GetBusesCount(); bus += static_cast<BusId>(stride)) {
+            length += catalogue.GetRouteInfo(bus).length_f;
+        }
+    }
+    return length;
+}
+
+}  // namespace
+
+// Сравнивает загрузку справочника с расчётом статистики маршрутов при добавлении (EAGER)
+// и при первом запросе (LAZY), когда запрашивается часть маршрутов или все:
+// ./bench_stats_mode [число маршрутов]
+int main(int argc, char* argv[]) {
+    const size_t buses_count = argc > 1 ? std::stoul(argv[1]) : 200'000;
+    const Network network = MakeNetwork(buses_count);
+
+    size_t length = 0;
+    for(size_t stride : {100, 1}) {
+        length += Measure(network, StatsMode::EAGER, "EAGER"sv, stride);
+        length += Measure(network, StatsMode::LAZY, "LAZY"sv, stride);
+    }
+    std::cerr << "buses: "sv << buses_count << ", stops: "sv << network.stops.size()
+              << ", length: "sv << length << '\n';
+}
@@ -0,0 +1,113 @@
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "log_duration.h"
+#include "memory_usage.h"
+#include "string_arena.h"
+
+using namespace catalogue;
+using namespace std::literals;
+
+namespace {
+
+// счётчики выделений динамической памяти во всей программе
+size_t allocations_count = 0;
+size_t allocated_bytes = 0;
+
+struct AllocationsCounter {
+    size_t count = allocations_count;
+    size_t bytes = allocated_bytes;
+
+    void Print(std::string_view name) const {
+        std::cerr << name << ": "sv << allocations_count - count << " allocations, "sv
+                  << ((allocated_bytes - bytes) >> 10) << " KB\n"sv;
+    }
+};
+
+// названия как в справочнике: остановки на кириллице и маршруты, часть которых совпадает с остановками
+std::vector<std::string> MakeNames(size_t count) {
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<size_t> number(0, 1'000'000'000);
+    std::vector<std::string> names;
+    names.reserve(count);
+    for(size_t i = 0; i < count; ++i) {
+        if(i % 10 == 0) {
+            names.push_back(std::to_string(number(generator) % 1000) + "К"s);
+        } else {
+            names.push_back("Остановка "s + std::to_string(number(generator)));
+        }
+    }
+    return names;
+}
+
+}  // namespace
+
+void* operator new(size_t size) {
+    ++allocations_count;
+    allocated_bytes += size;
+    if(void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+// Сравнивает хранение названий в отдельных std::string с хранилищем StringArena:
+// число выделений памяти, время и занятый объём: ./bench_string_arena [число названий]
+int main(int argc, char* argv[]) {
+    const size_t count = argc > 1 ? std::stoul(argv[1]) : 2'000'000;
+    const auto names = MakeNames(count);
+
+    // результаты накапливаются, чтобы компилятор не выбросил циклы
+    size_t length = 0;
+    {
+        const AllocationsCounter counter;
+        std::vector<std::string> strings;
+        {
+            LOG_DURATION("std::string copies"s);
+            for(const std::string& name : names) {
+                length += strings.emplace_back(name).size();
+            }
+        }
+        counter.Print("std::string copies"sv);
+        size_t usage = memory::GetUsage(strings);
+        for(const std::string& str : strings) {
+            // строки длиннее буфера короткой строки лежат в отдельном блоке
+            const auto* object = reinterpret_cast<const char*>(&str);
+            if(str.data() < object || str.data() >= object + sizeof(str)) {
+                usage += str.capacity() + 1;
+            }
+        }
+        std::cerr << "std::string copies memory: "sv << (usage >> 10) << " KB\n"sv;
+    }
+    {
+        const AllocationsCounter counter;
+        StringArena arena;
+        std::vector<std::string_view> views;
+        {
+            LOG_DURATION("StringArena::Intern"s);
+            for(const std::string& name : names) {
+                length += views.emplace_back(arena.Intern(name)).size();
+            }
+        }
+        counter.Print("StringArena::Intern"sv);
+        const size_t usage = memory::GetUsage(views);
+        std::cerr << "StringArena memory with index: "sv << ((arena.GetMemoryUsage() + usage) >> 10) << " KB\n"sv;
+        arena.ReleaseIndex();
+        std::cerr << "StringArena memory after ReleaseIndex: "sv << ((arena.GetMemoryUsage() + usage) >> 10)
+                  << " KB\n"sv;
+    }
+    std::cerr << "names: "sv << count << ", length: "sv << length << '\n';
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <utility>
+
+// Печатает в std::cerr время жизни объекта: LOG_DURATION("name") замеряет остаток блока
+class LogDuration {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit LogDuration(std::string name)
+        : name_(std::move(name)) {
+    }
+
+    ~LogDuration() {
+        const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start_);
+        std::cerr << name_ << ": " << duration.count() / 1000.0 << " ms\n";
+    }
+
+private:
+    std::string name_;
+    const Clock::time_point start_ = Clock::now();
+};
+
+#define LOG_DURATION_CONCAT_INTERNAL(X, Y) X##Y
+#define LOG_DURATION_CONCAT(X, Y) LOG_DURATION_CONCAT_INTERNAL(X, Y)
+#define LOG_DURATION(name) LogDuration LOG_DURATION_CONCAT(log_duration_, __LINE__)(name)
@@ -0,0 +1,46 @@
+#include "data_snapshot.h"
+
+namespace snapshot {
+
+DataSnapshot::DataSnapshot(uint64_t version, std::unique_ptr<catalogue::TransportCatalogue> catalogue,
+                           const renderer::detail::RenderSettings& render_settings,
+                           const router::RoutingSettings& routing_settings,
+                           const std::optional<router::RouterData>& router_data)
+    : version_(version),
+      catalogue_((catalogue->Freeze(), std::move(catalogue))),
+      renderer_(render_settings),
+      router_(routing_settings, *catalogue_, router_data) {
+}
+
+uint64_t DataSnapshot::GetVersion() const {
+    return version_;
+}
+
+const catalogue::TransportCatalogue& DataSnapshot::GetCatalogue() const {
+    return *catalogue_;
+}
+
+const renderer::MapRenderer& DataSnapshot::GetRenderer() const {
+    return renderer_;
+}
+
+const router::TransportRouter& DataSnapshot::GetRouter() const {
+    return router_;
+}
+
+std::shared_ptr<const DataSnapshot> SnapshotHolder::Get() const {
+    return current_.load(std::memory_order_acquire);
+}
+
+uint64_t SnapshotHolder::Publish(std::unique_ptr<catalogue::TransportCatalogue> catalogue,
+                                 const renderer::detail::RenderSettings& render_settings,
+                                 const router::RoutingSettings& routing_settings,
+                                 const std::optional<router::RouterData>& router_data) {
+    std::lock_guard lock(publish_mutex_);
+    auto snapshot = std::make_shared<const DataSnapshot>(last_version_ + 1, std::move(catalogue),
+                                                         render_settings, routing_settings, router_data);
+    current_.store(std::move(snapshot), std::memory_order_release);
+    return ++last_version_;
+}
+
+}  // namespace snapshot
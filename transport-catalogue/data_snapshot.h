@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+#include "map_renderer.h"
+#include "transport_catalogue.h"
+#include "transport_router.h"
+
+namespace snapshot {
+
+// Неизменяемая версия данных: замороженный справочник и построенные по нему отрисовщик
+// и маршрутизатор. Все три объекта живут, пока на версию есть хотя бы одна ссылка
+class DataSnapshot {
+public:
+    // замораживает справочник, если он ещё не заморожен, и строит по нему маршрутизатор;
+    // готовые граф и таблица router_data (из снимка справочника) используются без перестроения
+    DataSnapshot(uint64_t version, std::unique_ptr<catalogue::TransportCatalogue> catalogue,
+                 const renderer::detail::RenderSettings& render_settings,
+                 const router::RoutingSettings& routing_settings,
+                 const std::optional<router::RouterData>& router_data = std::nullopt);
+
+    uint64_t GetVersion() const;
+    const catalogue::TransportCatalogue& GetCatalogue() const;
+    const renderer::MapRenderer& GetRenderer() const;
+    const router::TransportRouter& GetRouter() const;
+
+private:
+    uint64_t version_;
+    // в куче: маршрутизатор хранит ссылку на справочник
+    std::unique_ptr<catalogue::TransportCatalogue> catalogue_;
+    renderer::MapRenderer renderer_;
+    router::TransportRouter router_;
+};
+
+// Публикует текущую версию данных. Читатели берут shared_ptr на версию в начале запроса
+// и работают с ней до его конца, не замечая публикации новой; старая версия освобождается
+// вместе с последней ссылкой на неё
+class SnapshotHolder {
+public:
+    // текущая версия, nullptr до первой публикации
+    std::shared_ptr<const DataSnapshot> Get() const;
+
+    // строит новую версию по справочнику и настройкам и атомарно подменяет ею текущую;
+    // построение идёт вне пути читателей. Возвращает номер опубликованной версии
+    uint64_t Publish(std::unique_ptr<catalogue::TransportCatalogue> catalogue,
+                     const renderer::detail::RenderSettings& render_settings,
+                     const router::RoutingSettings& routing_settings,
+                     const std::optional<router::RouterData>& router_data = std::nullopt);
+
+private:
+    std::atomic<std::shared_ptr<const DataSnapshot>> current_;
+    // упорядочивает публикации, чтобы номера версий росли в порядке подмены
+    std::mutex publish_mutex_;
+    uint64_t last_version_ = 0;
+};
+
+}  // namespace snapshot
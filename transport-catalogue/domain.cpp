@@ -1,9 +0,0 @@
-#include "domain.h"
-
-namespace domain {
-
-size_t StopHasher::operator()(std::pair<const Stop*, const Stop*> value) const noexcept{
-    return (hasher(value.first) << 32) + hasher(value.second);
-}
-
-}  // namespace domain
\ No newline at end of file
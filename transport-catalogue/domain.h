@@ -1,23 +1,108 @@
 #pragma once
 
-#include <string>
-#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <string_view>
 
 #include "geo.h"
 
 namespace domain {
 
 using namespace geo;
+
+// плотные идентификаторы остановок и маршрутов, назначаются справочником при добавлении
+using StopId = uint32_t;
+using BusId = uint32_t;
     
+// названия и остановки маршрута указывают в хранилище справочника; до добавления в справочник
+// они могут ссылаться на внешний буфер, который справочник копирует при добавлении
 struct Stop {
-    std::string name;
-    Coordinates coord;
+    std::string_view name;
+    CompactCoordinates coord;
+    StopId id = 0;
 };
 
+// stops - остановки в прямом направлении; обратный путь некольцевого маршрута не хранится,
+// полную последовательность остановок даёт RouteStops
 struct Bus {
-    std::string name;
-    std::vector<const Stop*> stops;
+    std::string_view name;
+    std::span<const StopId> stops;
     bool is_roundtrip;
+    BusId id = 0;
+};
+
+// Остановки маршрута в порядке движения без копирования: у некольцевого маршрута из L остановок
+// за прямым путём следует обратный без повтора конечной, всего 2L - 1 остановок
+class RouteStops {
+public:
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = StopId;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const StopId*;
+        using reference = StopId;
+
+        Iterator() = default;
+        Iterator(const RouteStops* route, size_t pos)
+            : route_{route}
+            , pos_{pos} {
+        }
+
+        StopId operator*() const {
+            return (*route_)[pos_];
+        }
+
+        Iterator& operator++() {
+            ++pos_;
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            auto old = *this;
+            ++pos_;
+            return old;
+        }
+
+        bool operator==(const Iterator& other) const {
+            return pos_ == other.pos_;
+        }
+
+    private:
+        const RouteStops* route_ = nullptr;
+        size_t pos_ = 0;
+    };
+
+    explicit RouteStops(const Bus& bus)
+        : stops_{bus.stops}
+        , is_roundtrip_{bus.is_roundtrip} {
+    }
+
+    size_t size() const {
+        return is_roundtrip_ || stops_.empty() ? stops_.size() : stops_.size() * 2 - 1;
+    }
+
+    bool empty() const {
+        return stops_.empty();
+    }
+
+    StopId operator[](size_t pos) const {
+        return pos < stops_.size() ? stops_[pos] : stops_[stops_.size() * 2 - 2 - pos];
+    }
+
+    Iterator begin() const {
+        return {this, 0};
+    }
+
+    Iterator end() const {
+        return {this, size()};
+    }
+
+private:
+    std::span<const StopId> stops_;
+    bool is_roundtrip_;
 };
 
 struct BusStats {
@@ -27,11 +112,4 @@ struct BusStats {
     double curvature;
 };
 
-class StopHasher {
-public:
-    size_t operator()(std::pair<const Stop*, const Stop*> value) const noexcept;
-private:
-    std::hash<const void*> hasher;
-};
-
-}// namespace domain
\ No newline at end of file
+}// namespace domain
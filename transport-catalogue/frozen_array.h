@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace catalogue {
+
+// Неизменяемый массив замороженного справочника: либо владеет элементами, либо ссылается
+// на чужую память (например, на отображённый в память файл снимка). Элементы не содержат указателей,
+// связи между массивами задаются индексами и смещениями, поэтому оба варианта равноправны
+template <typename T>
+class FrozenArray {
+public:
+    FrozenArray() = default;
+
+    // владеющий массив
+    explicit FrozenArray(std::vector<T> items)
+        : items_(std::move(items))
+        , view_(items_) {
+    }
+
+    // массив поверх чужой памяти, которая должна жить дольше него
+    explicit FrozenArray(std::span<const T> view)
+        : view_(view) {
+    }
+
+    // при перемещении вектора его буфер не меняется, поэтому view_ остаётся верным
+    FrozenArray(FrozenArray&&) = default;
+    FrozenArray& operator=(FrozenArray&&) = default;
+    FrozenArray(const FrozenArray&) = delete;
+    FrozenArray& operator=(const FrozenArray&) = delete;
+
+    const T& operator[](size_t index) const {
+        return view_[index];
+    }
+
+    size_t size() const {
+        return view_.size();
+    }
+
+    bool empty() const {
+        return view_.empty();
+    }
+
+    const T* data() const {
+        return view_.data();
+    }
+
+    auto begin() const {
+        return view_.begin();
+    }
+
+    auto end() const {
+        return view_.end();
+    }
+
+    std::span<const T> GetView() const {
+        return view_;
+    }
+
+    // объём собственной памяти в байтах; чужая память (например, отображённый файл) не учитывается
+    size_t GetMemoryUsage() const {
+        return items_.capacity() * sizeof(T);
+    }
+
+private:
+    std::vector<T> items_;
+    std::span<const T> view_;
+};
+
+}  // namespace catalogue
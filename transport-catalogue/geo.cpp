@@ -1,10 +1,85 @@
 #define _USE_MATH_DEFINES
 
+#include <algorithm>
 #include <cmath>
 #include "geo.h"
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define GEO_AVX2_KERNEL
+#endif
+
 namespace geo {
 
+namespace {
+
+const double DR = M_PI / 180.;
+const double MICRODEGREES = 1e6;
+// число отрезков, скалярные произведения которых считаются за один вызов ядра
+constexpr size_t PATH_BATCH = 64;
+
+// угол между точками единичной сферы по их скалярному произведению
+double AngleFromDot(double dot) {
+    return std::acos(std::clamp(dot, -1.0, 1.0));
+}
+
+// скалярные произведения соседних точек маршрута, dots[i] = points[route[i]] * points[route[i + 1]]
+void ComputeDotsScalar(const SpherePoint* points, const uint32_t* route, size_t count, double* dots) {
+    for(size_t i = 0; i + 1 < count; ++i) {
+        const SpherePoint& from = points[route[i]];
+        const SpherePoint& to = points[route[i + 1]];
+        dots[i] = from.x * to.x + from.y * to.y + from.z * to.z;
+    }
+}
+
+#ifdef GEO_AVX2_KERNEL
+// загружает base[idx[0]], ..., base[idx[3]]; вариант с маской и нулевым источником,
+// потому что _mm256_i32gather_pd читает неинициализированный регистр-источник
+__attribute__((target("avx2")))
+inline __m256d Gather(const double* base, __m128i idx) {
+    const __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    return _mm256_mask_i32gather_pd(_mm256_setzero_pd(), base, idx, all, 8);
+}
+
+// то же по четыре отрезка за шаг; порядок операций совпадает со скалярной версией,
+// поэтому результаты побитово одинаковы
+__attribute__((target("avx2")))
+void ComputeDotsAvx2(const SpherePoint* points, const uint32_t* route, size_t count, double* dots) {
+    const double* base = &points->x;
+    const __m128i stride = _mm_set1_epi32(sizeof(SpherePoint) / sizeof(double));
+    size_t i = 0;
+    for(; i + 4 < count; i += 4) {
+        // индексы первых координат точек в массиве double
+        __m128i from_idx = _mm_mullo_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(route + i)), stride);
+        __m128i to_idx = _mm_mullo_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(route + i + 1)), stride);
+
+        __m256d dot = _mm256_mul_pd(Gather(base, from_idx), Gather(base, to_idx));
+        dot = _mm256_add_pd(dot, _mm256_mul_pd(Gather(base + 1, from_idx), Gather(base + 1, to_idx)));
+        dot = _mm256_add_pd(dot, _mm256_mul_pd(Gather(base + 2, from_idx), Gather(base + 2, to_idx)));
+        _mm256_storeu_pd(dots + i, dot);
+    }
+    ComputeDotsScalar(points, route + i, count - i, dots + i);
+}
+
+bool HasAvx2() {
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    return has_avx2;
+}
+#endif
+
+// скалярные произведения отрезков route[0] -> ... -> route[count - 1] выбранным ядром
+void ComputeDots(PathKernel kernel, const SpherePoint* points, const uint32_t* route, size_t count, double* dots) {
+#ifdef GEO_AVX2_KERNEL
+    if(kernel == PathKernel::AVX2) {
+        ComputeDotsAvx2(points, route, count, dots);
+        return;
+    }
+#endif
+    ComputeDotsScalar(points, route, count, dots);
+}
+
+}  // namespace
+
 bool Coordinates::operator==(const Coordinates& other) const {
         return lat == other.lat && lng == other.lng;
 }
@@ -13,15 +88,97 @@ bool Coordinates::operator!=(const Coordinates& other) const {
         return !(*this == other);
 }
 
+CompactCoordinates::CompactCoordinates(Coordinates coord)
+    : lat_e6_{static_cast<int32_t>(std::lround(coord.lat * MICRODEGREES))},
+      lng_e6_{static_cast<int32_t>(std::lround(coord.lng * MICRODEGREES))} {
+}
+
+CompactCoordinates::operator Coordinates() const {
+    // деление, а не умножение на 1e-6: результат - ближайший double к точному значению
+    return {lat_e6_ / MICRODEGREES, lng_e6_ / MICRODEGREES};
+}
+
+bool SpherePoint::operator==(const SpherePoint& other) const {
+    return x == other.x && y == other.y && z == other.z;
+}
+
+SpherePoint ToSpherePoint(Coordinates coord) {
+    const double lat = coord.lat * DR;
+    const double lng = coord.lng * DR;
+    return {std::cos(lat) * std::cos(lng), std::cos(lat) * std::sin(lng), std::sin(lat)};
+}
+
 double ComputeDistance(Coordinates from, Coordinates to) {
     using namespace std;
     if (from == to) {
         return 0;
     }
-    const double dr = M_PI / 180.;
-    const int earth_radius = 6371000;
-    return acos(sin(from.lat * dr) * sin(to.lat * dr)
-                + cos(from.lat * dr) * cos(to.lat * dr) * cos(abs(from.lng - to.lng) * dr))
-        * earth_radius;
+    return acos(sin(from.lat * DR) * sin(to.lat * DR)
+                + cos(from.lat * DR) * cos(to.lat * DR) * cos(abs(from.lng - to.lng) * DR))
+        * EARTH_RADIUS;
+}
+
+double ComputeDistance(const SpherePoint& from, const SpherePoint& to) {
+    if (from == to) {
+        return 0;
+    }
+    return AngleFromDot(from.x * to.x + from.y * to.y + from.z * to.z) * EARTH_RADIUS;
 }
-}  // namespace geo
\ No newline at end of file
+
+// доступно ли ядро на этом процессоре
+bool IsSupported(PathKernel kernel) {
+    switch(kernel) {
+    case PathKernel::AVX2:
+#ifdef GEO_AVX2_KERNEL
+        return HasAvx2();
+#else
+        return false;
+#endif
+    default:
+        return true;
+    }
+}
+
+// возвращает длину ломаной points[route[0]] -> ... -> points[route[n - 1]] (и обратно при and_back)
+double ComputePathLength(std::span<const SpherePoint> points, std::span<const uint32_t> route, bool and_back,
+                         PathKernel kernel) {
+    if(route.size() < 2) {
+        return 0;
+    }
+    if(kernel == PathKernel::AUTO || !IsSupported(kernel)) {
+        kernel = IsSupported(PathKernel::AVX2) ? PathKernel::AVX2 : PathKernel::SCALAR;
+    }
+    // скалярные произведения считаются пакетами в буфер на стеке, без выделения памяти на каждый вызов
+    double dots[PATH_BATCH];
+    const size_t segments = route.size() - 1;
+    double length = 0;
+    for(size_t begin = 0; begin < segments; begin += PATH_BATCH) {
+        const size_t count = std::min(PATH_BATCH, segments - begin);
+        ComputeDots(kernel, points.data(), route.data() + begin, count + 1, dots);
+        for(size_t i = 0; i < count; ++i) {
+            // совпадающие точки дают 0 без погрешности acos вблизи единицы
+            if(points[route[begin + i]] != points[route[begin + i + 1]]) {
+                length += AngleFromDot(dots[i]) * EARTH_RADIUS;
+            }
+        }
+    }
+    if(and_back) {
+        // обратный путь проходит те же отрезки, скалярные произведения симметричны;
+        // пакеты пересчитываются с конца, а слагаемые добавляются в порядке движения,
+        // как при обходе развёрнутого маршрута
+        for(size_t end = segments; end > 0;) {
+            const size_t count = std::min(PATH_BATCH, end);
+            const size_t begin = end - count;
+            ComputeDots(kernel, points.data(), route.data() + begin, count + 1, dots);
+            for(size_t i = count; i-- > 0;) {
+                if(points[route[begin + i]] != points[route[begin + i + 1]]) {
+                    length += AngleFromDot(dots[i]) * EARTH_RADIUS;
+                }
+            }
+            end = begin;
+        }
+    }
+    return length;
+}
+
+}  // namespace geo
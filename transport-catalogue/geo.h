@@ -1,14 +1,67 @@
-#pragma once
-
-namespace geo {
-
-struct Coordinates {
-    double lat;
-    double lng;
-    bool operator==(const Coordinates& other) const;
-    bool operator!=(const Coordinates& other) const;
-};
-
-double ComputeDistance(Coordinates from, Coordinates to);
-
-}  // namespace geo
\ No newline at end of file
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+namespace geo {
+
+// средний радиус Земли, м
+inline constexpr int EARTH_RADIUS = 6371000;
+
+struct Coordinates {
+    double lat;
+    double lng;
+    bool operator==(const Coordinates& other) const;
+    bool operator!=(const Coordinates& other) const;
+};
+
+// Компактное хранение координат: целые микроградусы (8 байт вместо 16, точность ~0.1 м).
+// Координаты, заданные не более чем с 6 знаками после запятой, восстанавливаются без потерь
+class CompactCoordinates {
+public:
+    CompactCoordinates() = default;
+    CompactCoordinates(Coordinates coord);
+
+    // восстанавливает координаты в градусах
+    operator Coordinates() const;
+
+    bool operator==(const CompactCoordinates& other) const = default;
+
+private:
+    int32_t lat_e6_ = 0;
+    int32_t lng_e6_ = 0;
+};
+
+// Точка на единичной сфере (декартовы координаты), соответствующая географическим координатам.
+// Позволяет считать расстояние без повторного вычисления sin/cos широты и долготы
+struct SpherePoint {
+    double x;
+    double y;
+    double z;
+    bool operator==(const SpherePoint& other) const;
+};
+
+SpherePoint ToSpherePoint(Coordinates coord);
+
+double ComputeDistance(Coordinates from, Coordinates to);
+
+double ComputeDistance(const SpherePoint& from, const SpherePoint& to);
+
+// ядро пакетного расчёта скалярных произведений в ComputePathLength;
+// AUTO выбирает AVX2, если процессор его поддерживает. Все ядра дают побитово одинаковый результат
+enum class PathKernel {
+    AUTO,
+    SCALAR,
+    AVX2
+};
+
+// доступно ли ядро на этом процессоре
+bool IsSupported(PathKernel kernel);
+
+// возвращает длину ломаной points[route[0]] -> points[route[1]] -> ... -> points[route[n - 1]],
+// при and_back = true - вместе с обратным путём points[route[n - 1]] -> ... -> points[route[0]];
+// скалярные произведения считаются пакетами, недоступное ядро заменяется выбранным для AUTO
+double ComputePathLength(std::span<const SpherePoint> points, std::span<const uint32_t> route, bool and_back = false,
+                         PathKernel kernel = PathKernel::AUTO);
+
+}  // namespace geo
@@ -1,45 +1,74 @@
 #pragma once
 
+#include "frozen_array.h"
+#include "memory_usage.h"
 #include "ranges.h"
-#include <string_view>
 
+#include <cstdint>
 #include <cstdlib>
+#include <span>
+#include <stdexcept>
 #include <vector>
 
 namespace graph {
 
 using VertexId = size_t;
 using EdgeId = size_t;
-using RouteId = std::string_view;
+// маршрут ребра задаётся идентификатором (например, id автобуса или остановки)
+using RouteId = uint32_t;
 
+// поля упорядочены так, чтобы в структуре не было выравнивания: рёбра записываются в файл снимка как есть
 template <typename Weight>
 struct Edge {
     RouteId route_id;
+    int span_count = 0;
     VertexId from;
     VertexId to;
     Weight weight;
-    int span_count = 0;
 };
 
 template <typename Weight>
 class DirectedWeightedGraph {
 private:
     using IncidenceList = std::vector<EdgeId>;
-    using IncidentEdgesRange = ranges::Range<typename IncidenceList::const_iterator>;
+    using IncidentEdgesRange = ranges::Range<const EdgeId*>;
 
 public:
+    // упакованное представление: рёбра и списки инцидентных рёбер всех вершин одним массивом,
+    // рёбра вершины v - [incidence[incidence_offsets[v]], incidence[incidence_offsets[v + 1]])
+    struct Data {
+        std::span<const Edge<Weight>> edges;
+        std::span<const uint64_t> incidence_offsets;
+        std::span<const EdgeId> incidence;
+    };
+
     DirectedWeightedGraph() = default;
     explicit DirectedWeightedGraph(size_t vertex_count);
+    // использует упакованное представление из чужой памяти, которая должна жить дольше графа;
+    // при несогласованных данных выбрасывает std::runtime_error
+    explicit DirectedWeightedGraph(const Data& data);
     EdgeId AddEdge(const Edge<Weight>& edge);
+    // упаковывает списки инцидентных рёбер в единый массив, после этого добавление рёбер запрещено
+    void Compact();
 
     size_t GetVertexCount() const;
     size_t GetEdgeCount() const;
     const Edge<Weight>& GetEdge(EdgeId edge_id) const;
     IncidentEdgesRange GetIncidentEdges(VertexId vertex) const;
+    // упакованное представление, доступно после Compact()
+    Data GetData() const;
+    // приблизительный объём занятой памяти в байтах
+    size_t GetMemoryUsage() const;
 
 private:
     std::vector<Edge<Weight>> edges_;
     std::vector<IncidenceList> incidence_lists_;
+
+    // упакованное представление
+    catalogue::FrozenArray<Edge<Weight>> frozen_edges_;
+    catalogue::FrozenArray<uint64_t> incidence_offsets_;
+    catalogue::FrozenArray<EdgeId> incidence_;
+    bool is_compact_ = false;
 };
 
 template <typename Weight>
@@ -47,32 +76,112 @@ DirectedWeightedGraph<Weight>::DirectedWeightedGraph(size_t vertex_count)
     : incidence_lists_(vertex_count) {
 }
 
+template <typename Weight>
+DirectedWeightedGraph<Weight>::DirectedWeightedGraph(const Data& data)
+    : frozen_edges_(data.edges)
+    , incidence_offsets_(data.incidence_offsets)
+    , incidence_(data.incidence)
+    , is_compact_(true) {
+    const auto& offsets = data.incidence_offsets;
+    if(offsets.empty() || offsets.front() != 0 || offsets.back() != data.incidence.size()) {
+        throw std::runtime_error("Broken graph");
+    }
+    for(size_t i = 1; i < offsets.size(); ++i) {
+        if(offsets[i - 1] > offsets[i]) {
+            throw std::runtime_error("Broken graph");
+        }
+    }
+    const size_t vertex_count = offsets.size() - 1;
+    for(const auto& edge : data.edges) {
+        if(edge.from >= vertex_count || edge.to >= vertex_count) {
+            throw std::runtime_error("Broken graph");
+        }
+    }
+    for(EdgeId id : data.incidence) {
+        if(id >= data.edges.size()) {
+            throw std::runtime_error("Broken graph");
+        }
+    }
+}
+
 template <typename Weight>
 EdgeId DirectedWeightedGraph<Weight>::AddEdge(const Edge<Weight>& edge) {
+    if(is_compact_) {
+        throw std::logic_error("Graph is compacted");
+    }
     edges_.push_back(edge);
     const EdgeId id = edges_.size() - 1;
     incidence_lists_.at(edge.from).push_back(id);
     return id;
 }
 
+template <typename Weight>
+void DirectedWeightedGraph<Weight>::Compact() {
+    if(is_compact_) {
+        return;
+    }
+    std::vector<uint64_t> offsets;
+    std::vector<EdgeId> incidence;
+    offsets.reserve(incidence_lists_.size() + 1);
+    incidence.reserve(edges_.size());
+    offsets.push_back(0);
+    for(const IncidenceList& list : incidence_lists_) {
+        incidence.insert(incidence.end(), list.begin(), list.end());
+        offsets.push_back(incidence.size());
+    }
+    frozen_edges_ = catalogue::FrozenArray<Edge<Weight>>(std::move(edges_));
+    incidence_offsets_ = catalogue::FrozenArray<uint64_t>(std::move(offsets));
+    incidence_ = catalogue::FrozenArray<EdgeId>(std::move(incidence));
+    edges_ = {};
+    std::vector<IncidenceList>{}.swap(incidence_lists_);
+    is_compact_ = true;
+}
+
 template <typename Weight>
 size_t DirectedWeightedGraph<Weight>::GetVertexCount() const {
-    return incidence_lists_.size();
+    return is_compact_ ? incidence_offsets_.size() - 1 : incidence_lists_.size();
 }
 
 template <typename Weight>
 size_t DirectedWeightedGraph<Weight>::GetEdgeCount() const {
-    return edges_.size();
+    return is_compact_ ? frozen_edges_.size() : edges_.size();
 }
 
 template <typename Weight>
 const Edge<Weight>& DirectedWeightedGraph<Weight>::GetEdge(EdgeId edge_id) const {
-    return edges_.at(edge_id);
+    if(!is_compact_) {
+        return edges_.at(edge_id);
+    }
+    if(edge_id >= frozen_edges_.size()) {
+        throw std::out_of_range("Unknown edge");
+    }
+    return frozen_edges_[edge_id];
 }
 
 template <typename Weight>
 typename DirectedWeightedGraph<Weight>::IncidentEdgesRange
 DirectedWeightedGraph<Weight>::GetIncidentEdges(VertexId vertex) const {
-    return ranges::AsRange(incidence_lists_.at(vertex));
+    if(!is_compact_) {
+        const IncidenceList& list = incidence_lists_.at(vertex);
+        return {list.data(), list.data() + list.size()};
+    }
+    if(vertex >= GetVertexCount()) {
+        throw std::out_of_range("Unknown vertex");
+    }
+    return {incidence_.data() + incidence_offsets_[vertex], incidence_.data() + incidence_offsets_[vertex + 1]};
+}
+
+template <typename Weight>
+typename DirectedWeightedGraph<Weight>::Data DirectedWeightedGraph<Weight>::GetData() const {
+    if(!is_compact_) {
+        throw std::logic_error("Graph is not compacted");
+    }
+    return {frozen_edges_.GetView(), incidence_offsets_.GetView(), incidence_.GetView()};
+}
+
+template <typename Weight>
+size_t DirectedWeightedGraph<Weight>::GetMemoryUsage() const {
+    return memory::GetUsage(edges_) + memory::GetUsage(incidence_lists_) + frozen_edges_.GetMemoryUsage()
+           + incidence_offsets_.GetMemoryUsage() + incidence_.GetMemoryUsage();
 }
-}  // namespace graph
\ No newline at end of file
+}  // namespace graph
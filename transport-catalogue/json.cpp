@@ -1,5 +1,12 @@
 #include "json.h"
+#include "json_scan.h"
+#include "json_writer.h"
+
 #include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <optional>
+#include <unordered_set>
 
 using namespace std::literals;
 
@@ -7,21 +14,6 @@ namespace json {
 
 namespace {
 
-// считывает из потока подряд идущие буквы и возвращает
-void GetWord(std::istream& input, std::string& word) {
-    //std::string word;
-    while(std::isalpha(input.peek())) {
-        word.push_back(static_cast<char>(input.get()));
-    }
-    //return word;
-}
-
-bool IsEscapeSeq(char c) {
-    static const char escape_seq[] = "\r\n\t\"\\";
-    static const size_t size = 5;
-    return std::find(escape_seq, escape_seq + size, c) != escape_seq + size;
-}
-
 bool IsFromEscapeSeq(char c) {
     static const std::string escape_seq = "rnt\""s;
     return escape_seq.find(c) != escape_seq.npos;
@@ -46,340 +38,445 @@ char GetEscapeSeq(char c) {
     return escape_seq;
 }
 
-std::string GetDoubleEscapeSeq(char c) {
-    std::string escape_seq{};
-    switch(c) {
-        case '\n':
-        escape_seq = "\\n"s;
-        break;
-        case '\r':
-        escape_seq = "\\r"s;
-        break;
-        case '\t':
-        escape_seq = "\\t"s;
-        break;
-        case '\"':
-        escape_seq = "\\\""s;
-        break;
-        case '\\':
-        escape_seq = "\\\\"s;
-        break;
+// Разбор JSON из буфера: указатель идёт по символам без обращений к потоку.
+// Буфер либо задан целиком, либо дочитывается из потока блоками, тогда в памяти только текущий блок.
+// Грамматика и сообщения об ошибках совпадают с прежним разбором из потока
+class Parser {
+public:
+    // разбор документа, который ссылается на input: массивы и словари размещаются в resource,
+    // строки без экранирования остаются представлениями input
+    Parser(std::string_view input, std::pmr::memory_resource* resource)
+        : pos_(input.data())
+        , end_(input.data() + input.size())
+        , resource_(resource)
+        , string_views_(true) {
     }
-    return escape_seq;
-}
 
-// Функции чтения из потока
+    explicit Parser(std::string_view input)
+        : Parser(input, std::pmr::get_default_resource()) {
+    }
 
-// читает null из потока
-Node LoadNull(std::istream& input) {
-    std::string word;
-    GetWord(input, word);
+    explicit Parser(std::istream& input)
+        : stream_(&input)
+        , chunk_(CHUNK_SIZE) {
+    }
 
-    if(word != "null"sv) {
-        throw ParsingError("Failed to parse '"s + word + "' as null"s);
+    // читает Node и вызывает соответствующие загрузчики
+    Node LoadNode() {
+        if(!SkipSpaces()) {
+            throw ParsingError("Unexpected EOF"s);
+        }
+        switch(*pos_) {
+            case '[':
+                ++pos_;
+                return LoadArray();
+            case '{':
+                ++pos_;
+                return LoadDict();
+            case '"':
+                ++pos_;
+                return LoadStringNode();
+            default:
+                return LoadScalar();
+        }
     }
-    return Node{};
-}
 
-// читает bool из потока
-Node LoadBool(std::istream& input) {
-    std::string word;
-    GetWord(input, word);
-    
-    if(word == "true"sv) {
-        return Node{true};
-    } else if(word == "false"sv) {
-        return Node{false};
-    } else {
-        throw ParsingError("Failed to parse '"s + word + "' as bool"s);
+    // читает значение и сообщает о нём handler
+    void ParseNode(Handler& handler) {
+        if(!SkipSpaces()) {
+            throw ParsingError("Unexpected EOF"s);
+        }
+        switch(*pos_) {
+            case '[':
+                ++pos_;
+                return ParseArray(handler);
+            case '{':
+                ++pos_;
+                return ParseDict(handler);
+            case '"':
+                ++pos_;
+                return handler.String(LoadString());
+            default:
+                std::visit([&handler](auto&& value) { ReportScalar(handler, std::move(value)); },
+                           std::move(LoadScalar().GetValue()));
+        }
     }
-}
 
-// читает int и double из потока
-Node LoadNumber(std::istream& input) {
-    std::string parsed_num;
+private:
+    static constexpr size_t CHUNK_SIZE = 64 * 1024;
 
-    // Считывает в parsed_num очередной символ из input
-    auto read_char = [&parsed_num, &input] {
-        parsed_num += static_cast<char>(input.get());
-        if (!input) {
-            throw ParsingError("Failed to read number from stream"s);
-        }
-    };
+    // true, если буфер и поток исчерпаны; при исчерпании буфера дочитывает следующий блок
+    bool AtEnd() {
+        return pos_ == end_ && !Refill();
+    }
 
-    // Считывает одну или более цифр в parsed_num из input
-    auto read_digits = [&input, read_char] {
-        if (!std::isdigit(input.peek())) {
-            throw ParsingError("A digit is expected"s);
+    bool Refill() {
+        if(!stream_) {
+            return false;
         }
-        while (std::isdigit(input.peek())) {
-            read_char();
+        stream_->read(chunk_.data(), chunk_.size());
+        pos_ = chunk_.data();
+        end_ = pos_ + stream_->gcount();
+        return pos_ != end_;
+    }
+
+    // пропускает пробельные символы, возвращает false в конце ввода
+    bool SkipSpaces() {
+        while(!AtEnd()) {
+            pos_ = scan::SkipSpaces(pos_, end_);
+            if(pos_ != end_) {
+                return true;
+            }
         }
-    };
+        return false;
+    }
+
+    static bool IsDigit(char c) {
+        return c >= '0' && c <= '9';
+    }
 
-    if (input.peek() == '-') {
-        read_char();
+    static void ReportScalar(Handler& handler, std::nullptr_t) {
+        handler.Null();
+    }
+    static void ReportScalar(Handler& handler, bool value) {
+        handler.Bool(value);
+    }
+    static void ReportScalar(Handler& handler, int value) {
+        handler.Int(value);
+    }
+    static void ReportScalar(Handler& handler, double value) {
+        handler.Double(value);
+    }
+    // остальные типы LoadScalar не возвращает
+    template <typename Value>
+    static void ReportScalar(Handler&, Value&&) {
     }
-    // Парсим целую часть числа
-    if (input.peek() == '0') {
-        read_char();
-        // После 0 в JSON не могут идти другие цифры
-    } else {
-        read_digits();
+
+    // читает null, bool или число
+    Node LoadScalar() {
+        switch(*pos_) {
+            case 'n':
+                return LoadNull();
+            case 't':
+                [[fallthrough]];
+            case 'f':
+                return LoadBool();
+            default:
+                return LoadNumber();
+        }
     }
 
-    bool is_int = true;
-    // Парсим дробную часть числа
-    if (input.peek() == '.') {
-        read_char();
-        read_digits();
-        is_int = false;
+    // возвращает подряд идущие буквы
+    std::string GetWord() {
+        std::string word;
+        while(!AtEnd() && std::isalpha(static_cast<unsigned char>(*pos_))) {
+            word.push_back(*pos_++);
+        }
+        return word;
     }
 
-    // Парсим экспоненциальную часть числа
-    if (int ch = input.peek(); ch == 'e' || ch == 'E') {
-        read_char();
-        if (ch = input.peek(); ch == '+' || ch == '-') {
-            read_char();
+    // читает null
+    Node LoadNull() {
+        const auto word = GetWord();
+        if(word != "null"sv) {
+            throw ParsingError("Failed to parse '"s + word + "' as null"s);
         }
-        read_digits();
-        is_int = false;
+        return Node{};
     }
 
-    try {
-        if (is_int) {
-            // Сначала пробуем преобразовать строку в int
-            try {
-                return Node{std::stoi(parsed_num)};
-            } catch (...) {
-                // В случае неудачи, например, при переполнении,
-                // код ниже попробует преобразовать строку в double
-            }
+    // читает bool
+    Node LoadBool() {
+        const auto word = GetWord();
+        if(word == "true"sv) {
+            return Node{true};
+        } else if(word == "false"sv) {
+            return Node{false};
+        } else {
+            throw ParsingError("Failed to parse '"s + word + "' as bool"s);
         }
-        return Node{std::stod(parsed_num)};
-    } catch (...) {
-        throw ParsingError("Failed to convert "s + parsed_num + " to number"s);
     }
-}
 
-// читает string из потока
-Node LoadString(std::istream& input) {
-    std::string res{};
-    bool is_screened = false;
-    input >> std::noskipws;
-
-    char c;
-    for(; input >> c && (c != '\"' || is_screened == true);) {
-        if(c == '\\') {
-            if(is_screened == true) {
-                res.push_back(c);
-                is_screened = false;
-                continue;
+    // читает int и double
+    Node LoadNumber() {
+        // число разбирается from_chars прямо в буфере; если оно разорвано между блоками,
+        // прочитанная часть переносится в carry
+        const char* begin = pos_;
+        std::string carry;
+
+        // Есть ли следующий символ; перед подгрузкой блока сохраняет начало числа
+        auto has_char = [this, &begin, &carry] {
+            if(pos_ != end_) {
+                return true;
             }
-            is_screened = true;
-            continue;
-        } 
-        if(is_screened) {
-            if(IsFromEscapeSeq(c)) {
-                res.push_back(GetEscapeSeq(c));
-            } else {
-                throw ParsingError("Unrecognized escape sequence \\"s + c);
+            carry.append(begin, end_);
+            const bool refilled = Refill();
+            begin = pos_;
+            return refilled;
+        };
+
+        // Пропускает одну или более цифр
+        auto read_digits = [this, &has_char] {
+            if(!has_char() || !IsDigit(*pos_)) {
+                throw ParsingError("A digit is expected"s);
             }
-            is_screened = false;
-            continue;
+            do {
+                ++pos_;
+            } while(has_char() && IsDigit(*pos_));
+        };
+
+        if(has_char() && *pos_ == '-') {
+            ++pos_;
         }
-        if(c == '\n' || c == '\r') {
-                throw ParsingError("Unexpected end of line"s);
+        // Парсим целую часть числа
+        if(has_char() && *pos_ == '0') {
+            ++pos_;
+            // После 0 в JSON не могут идти другие цифры
+        } else {
+            read_digits();
         }
-        res.push_back(c);
-    }
-    if (!input) {
-        throw ParsingError("String parsing error"s);
-    }
-    input >> std::skipws;
-    return Node{move(res)};
-}
 
-Node LoadNode(std::istream& input);
+        bool is_int = true;
+        // Парсим дробную часть числа
+        if(has_char() && *pos_ == '.') {
+            ++pos_;
+            read_digits();
+            is_int = false;
+        }
 
-// читает Array из потока
-Node LoadArray(std::istream& input) {
-    Array result;
-    for (char c; input >> c && c != ']';) {
-        if (c != ',') {
-            input.putback(c);
+        // Парсим экспоненциальную часть числа
+        if(has_char() && (*pos_ == 'e' || *pos_ == 'E')) {
+            ++pos_;
+            if(has_char() && (*pos_ == '+' || *pos_ == '-')) {
+                ++pos_;
+            }
+            read_digits();
+            is_int = false;
         }
-        result.push_back(LoadNode(input));
-    }
-    if (!input) {
-        throw ParsingError("Array parsing error"s);
-    }
-    return Node(move(result));
-}
 
-// читает Dict из потока
-Node LoadDict(std::istream& input) {
-    Dict result;
-    for (char c; input >> c && c != '}';) {
-        if(c == '"') {
-            std::string key = LoadString(input).AsString();
-            if(input >> c && c == ':') {
-                if(result.find(key) != result.end()) {
-                    throw ParsingError("Duplicate of key '"s + key + "' was found"s);
-                }
-                result.emplace(move(key), LoadNode(input));
-            } else {
-                throw ParsingError("'"s + c + "' was found instead of ':'"s);
+        std::string_view text{begin, static_cast<size_t>(pos_ - begin)};
+        if(!carry.empty()) {
+            carry.append(text);
+            text = carry;
+        }
+        const char* const text_end = text.data() + text.size();
+        if(is_int) {
+            // Сначала пробуем преобразовать строку в int; при переполнении
+            // код ниже преобразует её в double
+            int value;
+            if(std::from_chars(text.data(), text_end, value).ec == std::errc{}) {
+                return Node{value};
             }
-        } else if(c != ',') {
-            throw ParsingError("'"s + c + "' was found instead of ','"s);
         }
+        double value;
+        if(std::from_chars(text.data(), text_end, value).ec != std::errc{}) {
+            throw ParsingError("Failed to convert "s + std::string(text) + " to number"s);
+        }
+        return Node{value};
     }
 
-    if(!input) {
-        throw ParsingError("Dictionary parsing error"s);
+    // читает string после открывающей кавычки
+    std::string LoadString() {
+        std::string res{};
+        while(true) {
+            // символы без экранирования копируются кусками до конца буфера
+            do {
+                const char* begin = pos_;
+                pos_ = scan::FindStringSpecial(pos_, end_);
+                res.append(begin, pos_);
+            } while(pos_ == end_ && Refill());
+            if(pos_ == end_) {
+                throw ParsingError("String parsing error"s);
+            }
+            const char c = *pos_++;
+            if(c == '"') {
+                return res;
+            }
+            if(c == '\n' || c == '\r') {
+                throw ParsingError("Unexpected end of line"s);
+            }
+            // экранированный символ
+            if(AtEnd()) {
+                throw ParsingError("String parsing error"s);
+            }
+            const char escaped = *pos_++;
+            if(escaped == '\\') {
+                res.push_back('\\');
+            } else if(IsFromEscapeSeq(escaped)) {
+                res.push_back(GetEscapeSeq(escaped));
+            } else {
+                throw ParsingError("Unrecognized escape sequence \\"s + escaped);
+            }
+        }
     }
-    return Node(move(result));
-}
 
-// читает Node из потока и вызывает соответствующие загрузчики
-Node LoadNode(std::istream& input) {  
-    char c;
-    if(!(input >> c)) {
-        throw ParsingError("Unexpected EOF"s);
-    };
-    switch(c) {
-        case '[':
-            return LoadArray(input);
-        case '{':
-            return LoadDict(input);
-        case '"':
-            return LoadString(input);
-        case 'n':
-            input.putback(c);
-            return LoadNull(input);
-        case 't':
-            [[fallthrough]];
-        case 'f':
-            input.putback(c);
-            return LoadBool(input);
-        default:
-            input.putback(c);
-            return LoadNumber(input);
+    // читает строку после открывающей кавычки; строка без экранирования становится
+    // представлением входного буфера, остальные копируются с заменой экранированных символов
+    Node LoadStringNode() {
+        if(string_views_) {
+            const char* begin = pos_;
+            pos_ = scan::FindStringSpecial(pos_, end_);
+            if(pos_ != end_ && *pos_ == '"') {
+                return Node{std::string_view(begin, pos_++ - begin)};
+            }
+            // экранирование или ошибка: строка разбирается заново с копированием
+            pos_ = begin;
+        }
+        return Node{LoadString()};
     }
-}
 
-// Функции вывода данных в поток в формате JSON
-// Структура для формирования отступа
-struct PrintContext {
-    std::ostream& out;
-    int indent_step = 4;
-    int indent = 0;
+    // Разбор массивов и словарей: после открывающей скобки до закрывающей.
+    // Запятые между элементами необязательны, как и при прежнем разборе из потока
 
-    void PrintIndent() const {
-        for (int i = 0; i < indent; ++i) {
-            out.put(' ');
+    // переходит к следующему элементу массива, возвращает false на закрывающей скобке
+    bool NextArrayItem() {
+        if(!SkipSpaces()) {
+            throw ParsingError("Array parsing error"s);
         }
+        if(*pos_ == ']') {
+            ++pos_;
+            return false;
+        }
+        if(*pos_ == ',') {
+            ++pos_;
+        }
+        return true;
     }
 
-    PrintContext Indented() const {
-        return {out, indent_step, indent_step + indent};
+    // читает ключ следующего элемента словаря вместе с ':', возвращает std::nullopt на закрывающей скобке
+    std::optional<std::string> NextDictKey() {
+        while(true) {
+            if(!SkipSpaces()) {
+                throw ParsingError("Dictionary parsing error"s);
+            }
+            const char c = *pos_++;
+            if(c == '}') {
+                return std::nullopt;
+            }
+            if(c == '"') {
+                std::string key = LoadString();
+                if(!SkipSpaces()) {
+                    throw ParsingError("Dictionary parsing error"s);
+                }
+                if(*pos_ != ':') {
+                    throw ParsingError("'"s + *pos_ + "' was found instead of ':'"s);
+                }
+                ++pos_;
+                return key;
+            }
+            if(c != ',') {
+                throw ParsingError("'"s + c + "' was found instead of ','"s);
+            }
+        }
     }
-};
-
-void PrintNode(const Node& node, const PrintContext& context);
 
-template<typename Value>
-void PrintValue(const Value& value, const PrintContext& context) {
-    context.out << value;
-}
+    Node LoadArray() {
+        Array result(resource_);
+        while(NextArrayItem()) {
+            result.push_back(LoadNode());
+        }
+        return Node(std::move(result));
+    }
 
-// Выводит "null" 
-template<>
-void PrintValue<std::nullptr_t>(const std::nullptr_t&, const PrintContext& context) {
-    context.out << "null"sv;
-}
+    // пары словаря копятся в общем стеке dict_items_, затем переносятся в словарь
+    // одним выделением памяти точного размера
+    Node LoadDict() {
+        const size_t start = dict_items_.size();
+        // ключи большого словаря; повторы ключей небольшого ищутся перебором в dict_items_
+        std::unordered_set<std::string> keys;
+        while(auto key = NextDictKey()) {
+            if(IsDuplicateKey(start, *key, keys)) {
+                throw ParsingError("Duplicate of key '"s + *key + "' was found"s);
+            }
+            Node value = LoadNode();
+            dict_items_.emplace_back(std::move(*key), std::move(value));
+        }
+        Dict result(std::make_move_iterator(dict_items_.begin() + start),
+                    std::make_move_iterator(dict_items_.end()), resource_);
+        dict_items_.resize(start);
+        return Node(std::move(result));
+    }
 
-// Выводит string
-template<>
-void PrintValue<std::string>(const std::string& str, const PrintContext& context) {
-    context.out << "\"";
-    for(const char& c : str) {
-        if(IsEscapeSeq(c)) {
-            context.out << GetDoubleEscapeSeq(c);
-        } else {
-            context.out << c;
+    // проверяет, встречался ли key среди пар словаря, начинающихся с dict_items_[start]
+    bool IsDuplicateKey(size_t start, const std::string& key, std::unordered_set<std::string>& keys) const {
+        static constexpr size_t MAX_LINEAR_SEARCH = 16;
+        const size_t count = dict_items_.size() - start;
+        if(count < MAX_LINEAR_SEARCH) {
+            return std::any_of(dict_items_.begin() + start, dict_items_.end(),
+                               [&key](const Dict::value_type& item) { return item.first == key; });
         }
+        if(keys.empty()) {
+            for(auto it = dict_items_.begin() + start; it != dict_items_.end(); ++it) {
+                keys.insert(it->first);
+            }
+        }
+        return !keys.insert(key).second;
     }
-    context.out << "\"";
-}
 
-// Выводит тип bool
-template<>
-void PrintValue<bool>(const bool& value, const PrintContext& context) {
-    context.out << std::boolalpha << value;
-}
+    void ParseArray(Handler& handler) {
+        handler.StartArray();
+        while(NextArrayItem()) {
+            ParseNode(handler);
+        }
+        handler.EndArray();
+    }
 
-// Выводит Array
-template<>
-void PrintValue<Array>(const Array& array, const PrintContext& context) {
-    std::ostream& out = context.out;
-    bool first = true;
-    out << "[\n"sv;
-    auto inner_context = context.Indented();
-    for(const auto& node : array) {
-        if(first) {
-            first = false;
-        } else {
-            out << ",\n"sv;
+    void ParseDict(Handler& handler) {
+        handler.StartDict();
+        while(auto key = NextDictKey()) {
+            handler.Key(std::move(*key));
+            ParseNode(handler);
         }
-        inner_context.PrintIndent();
-        PrintNode(node, inner_context);
+        handler.EndDict();
     }
-    out.put('\n');
-    context.PrintIndent();
-    out.put(']');
+
+    const char* pos_ = nullptr;
+    const char* end_ = nullptr;
+    // источник следующих блоков, nullptr при разборе готового буфера
+    std::istream* stream_ = nullptr;
+    std::vector<char> chunk_;
+    std::pmr::memory_resource* resource_ = std::pmr::get_default_resource();
+    // строки без экранирования возвращаются представлениями буфера, а не копиями
+    bool string_views_ = false;
+    // пары незавершённых словарей, от внешнего к внутреннему
+    std::vector<Dict::value_type> dict_items_;
+};
+
+}  // namespace
+
+// Загрузка json-документа из буфера: массивы и словари размещаются в монотонной арене документа,
+// которая освобождается целиком, строки без экранирования ссылаются на input
+Document Load(std::string_view input) {
+    auto arena = std::make_shared<std::pmr::monotonic_buffer_resource>();
+    Node root = Parser(input, arena.get()).LoadNode();
+    return Document{std::move(root), std::move(arena)};
 }
 
-// Выводит Dict
-template<>
-void PrintValue<Dict>(const Dict& dict, const PrintContext& context) {
-    std::ostream& out = context.out;
-    bool first = true;
-    out << "{\n"sv;
-    auto inner_context = context.Indented();
-    for(auto& [key, node] : dict) {
-        if(first) {
-            first = false;
-        } else {
-            out << ",\n"sv;
-        }
-        context.PrintIndent();
-        PrintValue(key, context);
-        out << ": "sv;
-        PrintNode(node, inner_context);
+// Загрузка json-документа из потока: поток читается целиком, затем разбирается как буфер,
+// который остаётся в документе
+Document Load(std::istream& input) {
+    auto buffer = std::make_shared<std::string>();
+    char chunk[64 * 1024];
+    while(input.read(chunk, sizeof(chunk)) || input.gcount() > 0) {
+        buffer->append(chunk, static_cast<size_t>(input.gcount()));
     }
-    out.put('\n');
-    context.PrintIndent();
-    out.put('}');
+    auto arena = std::make_shared<std::pmr::monotonic_buffer_resource>();
+    Node root = Parser(*buffer, arena.get()).LoadNode();
+    return Document{std::move(root), std::move(arena), std::move(buffer)};
 }
 
-// Выводит в поток Node
-void PrintNode(const Node& node, const PrintContext& context) {
-    visit(
-        [&context](const auto& value) { PrintValue(value, context);},
-        node.GetValue());
+// Потоковый разбор из буфера
+void Parse(std::string_view input, Handler& handler) {
+    Parser(input).ParseNode(handler);
 }
-}  // namespace
 
-// Загрузка json-документа из потока
-Document Load(std::istream& input) {
-    return Document{LoadNode(input)};
+// Потоковый разбор из потока, читаемого блоками
+void Parse(std::istream& input, Handler& handler) {
+    Parser(input).ParseNode(handler);
 }
 
 // Вывод json-документа в поток
 void Print(const Document& doc, std::ostream& output) {
-    PrintNode(doc.GetRoot(), PrintContext{output});
+    Writer(output).Value(doc.GetRoot().GetValue());
 }
 
 }  // namespace json
\ No newline at end of file
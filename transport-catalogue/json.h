@@ -1,18 +1,76 @@
 #pragma once
 
+#include <algorithm>
 #include <iostream>
-#include <map>
+#include <memory>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <cstddef>
+#include <stdexcept>
+#include <utility>
 #include <variant>
 
 namespace json {
 
 class Node;
 
-using Dict = std::map<std::string, Node>;
-using Array = std::vector<Node>;
+// Контейнеры узлов выделяют память через std::pmr: узлы документа, загруженного Load,
+// размещаются в арене документа, остальные - в куче (ресурс по умолчанию).
+// Копия узла всегда размещается в куче, поэтому её можно хранить дольше документа.
+// Строки документа, загруженного Load, ссылаются на входной буфер (std::string_view), если в них
+// нет экранированных символов; при копировании узла такая строка копируется
+using Array = std::pmr::vector<Node>;
+
+// Словарь: пары ключ-значение в непрерывном векторе, отсортированном по ключу.
+// В объектах запросов 3-12 ключей, и двоичный поиск по вектору быстрее обхода дерева.
+// Обход идёт по возрастанию ключей, как у std::map; поиск принимает std::string_view
+class Dict {
+public:
+    using value_type = std::pair<std::string, Node>;
+    using const_iterator = std::pmr::vector<value_type>::const_iterator;
+
+    Dict() = default;
+    explicit Dict(std::pmr::memory_resource* resource) : items_(resource) {
+    }
+
+    // создаёт словарь из пар [first, last) с различными ключами в любом порядке
+    template <typename InputIt>
+    Dict(InputIt first, InputIt last, std::pmr::memory_resource* resource);
+
+    const_iterator begin() const {
+        return items_.begin();
+    }
+    const_iterator end() const {
+        return items_.end();
+    }
+    size_t size() const {
+        return items_.size();
+    }
+    bool empty() const {
+        return items_.empty();
+    }
+
+    const_iterator find(std::string_view key) const;
+    bool contains(std::string_view key) const;
+    // выбрасывает std::out_of_range при отсутствии ключа
+    const Node& at(std::string_view key) const;
+
+    // добавляет пару, если ключа ещё нет; возвращает итератор на элемент с ключом и признак вставки
+    std::pair<const_iterator, bool> emplace(std::string key, Node value);
+    // возвращает значение по ключу, добавляя пустое при отсутствии
+    Node& operator[](std::string key);
+
+    bool operator==(const Dict& other) const;
+
+private:
+    // первая пара с ключом не меньше key
+    std::pmr::vector<value_type>::iterator LowerBound(std::string_view key);
+    const_iterator LowerBound(std::string_view key) const;
+
+    std::pmr::vector<value_type> items_;
+};
 
 // Эта ошибка должна выбрасываться при ошибках парсинга JSON
 class ParsingError : public std::runtime_error {
@@ -21,15 +79,29 @@ public:
 };
 
 class Node final 
-    : private std::variant<std::nullptr_t, int, double, bool, std::string, Array, Dict> {
+    : private std::variant<std::nullptr_t, int, double, bool, std::string, std::string_view, Array, Dict> {
 public:
     using variant::variant;
     using variant::operator=;
     using Value = variant;
 
+    Node() = default;
     Node(Value&& value) : Value(std::move(value)) {
     }
 
+    // копия не ссылается на входной буфер документа
+    Node(const Node& other) : Value(other.CopyValue()) {
+    }
+    Node(Node&&) = default;
+
+    Node& operator=(const Node& other) {
+        if(this != &other) {
+            GetValue() = other.CopyValue();
+        }
+        return *this;
+    }
+    Node& operator=(Node&&) = default;
+
     // Методы сообщают, хранится ли внутри значение некоторого типа:
     bool IsNull() const {
         return std::holds_alternative<std::nullptr_t>(*this);
@@ -47,7 +119,7 @@ public:
         return std::holds_alternative<bool>(*this);
     }
     bool IsString() const {
-        return std::holds_alternative<std::string>(*this);
+        return std::holds_alternative<std::string>(*this) || std::holds_alternative<std::string_view>(*this);
     }
     bool IsArray() const {
         return std::holds_alternative<Array>(*this);
@@ -75,11 +147,15 @@ public:
         } 
         return std::get<bool>(*this);
     }
-    const std::string& AsString() const {
-        if(!IsString()) {
-            throw std::logic_error("The node type is not string");
-        } 
-        return std::get<std::string>(*this);
+    // строка действительна, пока жив узел (и входной буфер документа)
+    std::string_view AsString() const {
+        if(const auto* view = std::get_if<std::string_view>(this)) {
+            return *view;
+        }
+        if(const auto* str = std::get_if<std::string>(this)) {
+            return *str;
+        }
+        throw std::logic_error("The node type is not string");
     }
     const Array& AsArray() const {
         if(!IsArray()) {
@@ -96,6 +172,10 @@ public:
     
     // Методы сравнения двух экземпляров Node
     bool operator==(const Node& other) const noexcept {
+        // собственная строка и строка-представление равны при равном содержимом
+        if(IsString() && other.IsString()) {
+            return AsString() == other.AsString();
+        }
         return this->GetValue() == other.GetValue();
     }
     bool operator!=(const Node& other) const noexcept {
@@ -109,13 +189,92 @@ public:
     Value& GetValue() {
         return *this;
     }
+
+private:
+    // копия значения, в которой строки-представления заменены собственными строками
+    Value CopyValue() const {
+        if(const auto* view = std::get_if<std::string_view>(this)) {
+            return std::string(*view);
+        }
+        return GetValue();
+    }
 };
 
+// Методы Dict используют полный тип Node
+template <typename InputIt>
+Dict::Dict(InputIt first, InputIt last, std::pmr::memory_resource* resource)
+    : items_(first, last, resource) {
+    const auto less = [](const value_type& lhs, const value_type& rhs) { return lhs.first < rhs.first; };
+    if(!std::is_sorted(items_.begin(), items_.end(), less)) {
+        std::sort(items_.begin(), items_.end(), less);
+    }
+}
+
+inline Dict::const_iterator Dict::LowerBound(std::string_view key) const {
+    return std::lower_bound(items_.begin(), items_.end(), key,
+                            [](const value_type& item, std::string_view key) { return item.first < key; });
+}
+
+inline std::pmr::vector<Dict::value_type>::iterator Dict::LowerBound(std::string_view key) {
+    return items_.begin() + (std::as_const(*this).LowerBound(key) - items_.cbegin());
+}
+
+inline Dict::const_iterator Dict::find(std::string_view key) const {
+    const auto it = LowerBound(key);
+    return it != items_.end() && it->first == key ? it : items_.end();
+}
+
+inline bool Dict::contains(std::string_view key) const {
+    return find(key) != items_.end();
+}
+
+inline const Node& Dict::at(std::string_view key) const {
+    const auto it = find(key);
+    if(it == items_.end()) {
+        throw std::out_of_range("Dict::at");
+    }
+    return it->second;
+}
+
+inline std::pair<Dict::const_iterator, bool> Dict::emplace(std::string key, Node value) {
+    // ключи разобранного документа часто уже упорядочены
+    if(items_.empty() || items_.back().first < key) {
+        items_.emplace_back(std::move(key), std::move(value));
+        return {std::prev(items_.cend()), true};
+    }
+    const auto it = LowerBound(key);
+    if(it != items_.end() && it->first == key) {
+        return {it, false};
+    }
+    return {items_.emplace(it, std::move(key), std::move(value)), true};
+}
+
+inline Node& Dict::operator[](std::string key) {
+    const auto it = LowerBound(key);
+    if(it != items_.end() && it->first == key) {
+        return it->second;
+    }
+    return items_.emplace(it, std::move(key), Node{})->second;
+}
+
+inline bool Dict::operator==(const Dict& other) const {
+    return items_ == other.items_;
+}
+
 class Document {
 public:
     explicit Document(Node root) : root_(move(root)) {
     }
 
+    // массивы и словари root размещены в arena, строки могут ссылаться на source;
+    // арена и буфер освобождаются вместе с документом
+    Document(Node root, std::shared_ptr<std::pmr::memory_resource> arena,
+             std::shared_ptr<const std::string> source = nullptr)
+        : source_(std::move(source))
+        , arena_(std::move(arena))
+        , root_(move(root)) {
+    }
+
     const Node& GetRoot() const {
         return root_;
     }
@@ -128,10 +287,41 @@ public:
         return !(*this == other);
     }
 private:
+    // объявлены до root_, чтобы узлы уничтожались раньше арены и входного буфера
+    std::shared_ptr<const std::string> source_;
+    std::shared_ptr<std::pmr::memory_resource> arena_;
     Node root_;
 };
 
-// Загрузка json-документа из потока
+// Обработчик событий потокового разбора (SAX): значения сообщаются по мере чтения, дерево Node
+// не строится. Повторы ключей словаря не проверяются
+class Handler {
+public:
+    virtual void Null() = 0;
+    virtual void Bool(bool value) = 0;
+    virtual void Int(int value) = 0;
+    virtual void Double(double value) = 0;
+    virtual void String(std::string value) = 0;
+    virtual void StartArray() = 0;
+    virtual void EndArray() = 0;
+    virtual void StartDict() = 0;
+    virtual void Key(std::string key) = 0;
+    virtual void EndDict() = 0;
+
+protected:
+    ~Handler() = default;
+};
+
+// Потоковый разбор json-документа: события передаются handler по мере чтения.
+// Поток читается блоками, поэтому в памяти одновременно находится только текущий блок
+void Parse(std::string_view input, Handler& handler);
+void Parse(std::istream& input, Handler& handler);
+
+// Загрузка json-документа из непрерывного буфера (строки, прочитанного или отображённого в память файла).
+// Строки документа ссылаются на input: буфер должен жить дольше документа и его узлов
+Document Load(std::string_view input);
+
+// Загрузка json-документа из потока; прочитанный буфер хранится в документе
 Document Load(std::istream& input);
 
 // Вывод json-документа в поток
@@ -1,6 +1,11 @@
 #include "json_reader.h"
 #include "json_builder.h"
+#include "json_writer.h"
 
+#include <algorithm>
+#include <future>
+#include <limits>
+#include <optional>
 #include <stdexcept>
 #include <sstream>
 
@@ -26,7 +31,7 @@ Color NodeToColor(const json::Node& node) {
                                     static_cast<uint8_t>(array[2].AsInt()), 
                                     array[3].AsDouble()}};
     }
-    return svg::Color{node.AsString()};
+    return svg::Color{std::string(node.AsString())};
 }    
 
 // Преобразует вектор json::Node'ов в вектор svg::Color'ов
@@ -38,238 +43,545 @@ std::vector<Color> ArrayToColorVector(const Array& array) {
     return colors;
 }
 
-// Возвращает словарь, заполненный информацией о маршруте
-Node GetBusInfo(const TransportCatalogue& transport_catalogue, const Dict& bus_request) {
-    auto bus = transport_catalogue.GetBus(bus_request.at("name"s).AsString());
+// Функции ответов на запросы выводят словарь ответа в output - json::Builder или json::Writer.
+// Ключи выводятся по алфавиту: в таком порядке их выводит и Print, обходящий json::Dict - вектор, отсортированный по ключу
+
+// Выводит словарь с сообщением об ошибке запроса
+template <typename Output>
+void WriteError(Output& output, int request_id, std::string message) {
+    output.StartDict()
+              .Key("error_message"s).Value(std::move(message))
+              .Key("request_id"s).Value(request_id)
+          .EndDict();
+}
+
+// Выводит словарь, заполненный информацией о маршруте
+template <typename Output>
+void GetBusInfo(const TransportCatalogue& transport_catalogue, const Dict& bus_request, Output& output) {
+    auto bus = transport_catalogue.GetBus(bus_request.at("name"sv).AsString());
 
     if(!bus) {
-        return json::Builder{}
-            .StartDict()
-                .Key("request_id"s).Value(bus_request.at("id"s).AsInt())
-                .Key("error_message"s).Value("not found"s)
-            .EndDict()
-            .Build();
+        WriteError(output, bus_request.at("id"sv).AsInt(), "not found"s);
+        return;
     }
 
     auto bus_stats = transport_catalogue.GetRouteInfo(bus);
 
-    return json::Builder{}
-        .StartDict()
-            .Key("curvature"s).Value(bus_stats.curvature)
-            .Key("request_id"s).Value(bus_request.at("id"s).AsInt())
-            .Key("route_length"s).Value(static_cast<int>(bus_stats.length_f))
-            .Key("stop_count"s).Value(static_cast<int>(bus_stats.stops_num))
-            .Key("unique_stop_count"s).Value(static_cast<int>(bus_stats.unique_stops))
-        .EndDict()
-        .Build();
-        // Возможно переполнение при преобразовании из size_t в int
+    output.StartDict()
+              .Key("curvature"s).Value(bus_stats.curvature)
+              .Key("request_id"s).Value(bus_request.at("id"sv).AsInt())
+              .Key("route_length"s).Value(static_cast<int>(bus_stats.length_f))
+              .Key("stop_count"s).Value(static_cast<int>(bus_stats.stops_num))
+              .Key("unique_stop_count"s).Value(static_cast<int>(bus_stats.unique_stops))
+          .EndDict();
+          // Возможно переполнение при преобразовании из size_t в int
 }
 
-// Возвращает словарь, заполненный информацией об остановке
-Node GetStopInfo(const TransportCatalogue& transport_catalogue, const Dict& stop_request) {
-    auto stop = transport_catalogue.GetStop(stop_request.at("name"s).AsString());
+// Выводит словарь, заполненный информацией об остановке
+template <typename Output>
+void GetStopInfo(const TransportCatalogue& transport_catalogue, const Dict& stop_request, Output& output) {
+    auto stop = transport_catalogue.GetStop(stop_request.at("name"sv).AsString());
 
     if(!stop) {
-        return Builder{}
-            .StartDict()
-                .Key("request_id"s).Value(stop_request.at("id"s).AsInt())
-                .Key("error_message"s).Value("not found"s)
-            .EndDict()
-            .Build();
+        WriteError(output, stop_request.at("id"sv).AsInt(), "not found"s);
+        return;
     }
 
-    auto stop_stats = transport_catalogue.GetStopInfo(stop);
+    output.StartDict()
+              .Key("buses"s).StartArray();
+    for(std::string_view bus : transport_catalogue.GetStopInfo(stop)) {
+        output.Value(std::string(bus));
+    }
+    output.EndArray()
+              .Key("request_id"s).Value(stop_request.at("id"sv).AsInt())
+          .EndDict();
+}
 
-    Array buses{};
-    for(std::string_view bus : stop_stats) {
-        buses.push_back(std::string(bus));
+// Выводит словарь со списком названий остановок
+template <typename Output, typename Stops>
+void WriteStopNames(Output& output, int request_id, const Stops& stops) {
+    output.StartDict()
+              .Key("request_id"s).Value(request_id)
+              .Key("stops"s).StartArray();
+    for(const Stop* stop : stops) {
+        output.Value(std::string(stop->name));
     }
+    output.EndArray()
+          .EndDict();
+}
+
+// Выводит словарь с ближайшими к точке остановками
+template <typename Output>
+void GetNearestStops(const TransportCatalogue& transport_catalogue, const Dict& nearest_request, Output& output) {
+    const geo::Coordinates point{nearest_request.at("latitude"sv).AsDouble(),
+                                 nearest_request.at("longitude"sv).AsDouble()};
+    const size_t count = std::max(nearest_request.at("count"sv).AsInt(), 0);
+    // без радиуса поиск не ограничен расстоянием
+    const double radius = nearest_request.contains("radius"sv)
+        ? nearest_request.at("radius"sv).AsDouble() : std::numeric_limits<double>::infinity();
 
-    return Builder{}
-        .StartDict()
-            .Key("request_id"s).Value(stop_request.at("id"s).AsInt())
-            .Key("buses"s).Value(buses)
-        .EndDict()
-        .Build();
+    output.StartDict()
+              .Key("request_id"s).Value(nearest_request.at("id"sv).AsInt())
+              .Key("stops"s).StartArray();
+    for(const auto& [stop, distance] : transport_catalogue.GetNearestStops(point, count, radius)) {
+        output.StartDict()
+                  .Key("distance"s).Value(distance)
+                  .Key("name"s).Value(std::string(stop->name))
+              .EndDict();
+    }
+    output.EndArray()
+          .EndDict();
+}
+
+// Выводит словарь с остановками внутри прямоугольника координат
+template <typename Output>
+void GetStopsInBox(const TransportCatalogue& transport_catalogue, const Dict& box_request, Output& output) {
+    const geo::Coordinates min{box_request.at("min_latitude"sv).AsDouble(), box_request.at("min_longitude"sv).AsDouble()};
+    const geo::Coordinates max{box_request.at("max_latitude"sv).AsDouble(), box_request.at("max_longitude"sv).AsDouble()};
+
+    WriteStopNames(output, box_request.at("id"sv).AsInt(), transport_catalogue.GetStopsInBox(min, max));
 }
 
-// Возвращает словарь, заполненный информацией, необходимой для отрисовки маршрутов
-Node GetRoutesMap(const RequestHandler& request_handler, const Dict& map_request) {
+// Выводит словарь с остановками, подходящими под начало названия
+template <typename Output>
+void GetStopSearch(const TransportCatalogue& transport_catalogue, const Dict& search_request, Output& output) {
+    const size_t limit = std::max(search_request.at("limit"sv).AsInt(), 0);
+    // без допустимого числа опечаток ищем точное совпадение начала названия
+    const size_t max_distance = search_request.contains("max_distance"sv)
+        ? std::max(search_request.at("max_distance"sv).AsInt(), 0) : 0;
+
+    WriteStopNames(output, search_request.at("id"sv).AsInt(),
+                   transport_catalogue.SearchStops(search_request.at("query"sv).AsString(), max_distance, limit));
+}
+
+// Выводит словарь, заполненный информацией, необходимой для отрисовки маршрутов
+template <typename Output>
+void GetRoutesMap(const RequestHandler& request_handler, const Dict& map_request, Output& output) {
     std::ostringstream out_str;
     request_handler.RenderMap().Render(out_str);
 
-    return Builder{}
-        .StartDict()
-            .Key("request_id"s).Value(map_request.at("id"s).AsInt())
-            .Key("map"s).Value(out_str.str())
-        .EndDict()
-        .Build();
+    output.StartDict()
+              .Key("map"s).Value(out_str.str())
+              .Key("request_id"s).Value(map_request.at("id"sv).AsInt())
+          .EndDict();
 }
 
 // получение информации о части маршрута
 // ожидание автобуса на остановках
-void GetRoutePart(const router::WaitingPart& part, Builder& builder) {
-    builder.StartDict()
-               .Key("type"s).Value(part.type)
-               .Key("stop_name"s).Value(std::string(part.stop_name))
-               .Key("time"s).Value(part.travel_time)
-           .EndDict();   
+template <typename Output>
+void GetRoutePart(const router::WaitingPart& part, Output& output) {
+    output.StartDict()
+              .Key("stop_name"s).Value(std::string(part.stop_name))
+              .Key("time"s).Value(part.travel_time)
+              .Key("type"s).Value(part.type)
+          .EndDict();
 }
 // проезд на автобусе
-void GetRoutePart(const router::TransitPart& part, Builder& builder) {
-    builder.StartDict()
-               .Key("type"s).Value(part.type)
-               .Key("bus"s).Value(std::string(part.bus_name))
-               .Key("span_count"s).Value(part.span_count)
-               .Key("time"s).Value(part.travel_time)
-           .EndDict();
+template <typename Output>
+void GetRoutePart(const router::TransitPart& part, Output& output) {
+    output.StartDict()
+              .Key("bus"s).Value(std::string(part.bus_name))
+              .Key("span_count"s).Value(part.span_count)
+              .Key("time"s).Value(part.travel_time)
+              .Key("type"s).Value(part.type)
+          .EndDict();
 }
 
-// Возвращает словарь, заполненный информацией, об оптимальном маршруте между двумя остановками
-Node GetRouteInfo(const RequestHandler& request_handler, const Dict& route_request) {
-    Builder builder{};
-    builder.StartDict()
-               .Key("request_id"s).Value(route_request.at("id"s).AsInt());
+// Выводит словарь, заполненный информацией, об оптимальном маршруте между двумя остановками
+template <typename Output>
+void GetRouteInfo(const RequestHandler& request_handler, const Dict& route_request, Output& output) {
     // пытаемтся построить оптимальный маршрут
-    auto route = request_handler.GetRoute(route_request.at("from"s).AsString(), route_request.at("to"s).AsString());
+    auto route = request_handler.GetRoute(route_request.at("from"sv).AsString(), route_request.at("to"sv).AsString());
     if(!route) {
-        return builder.Key("error_message"s).Value("not found"s)
-            .EndDict().Build();
+        WriteError(output, route_request.at("id"sv).AsInt(), "not found"s);
+        return;
     }
-    builder.Key("items"s).StartArray();
+    output.StartDict()
+              .Key("items"s).StartArray();
     // выводим этапы маршрута
     for(const auto& route_part : route->route_parts) {
-        std::visit([&builder](const auto& part) { GetRoutePart(part, builder);}, route_part);
+        std::visit([&output](const auto& part) { GetRoutePart(part, output);}, route_part);
+    }
+    output.EndArray()
+              .Key("request_id"s).Value(route_request.at("id"sv).AsInt())
+              .Key("total_time"s).Value(route->total_time)
+          .EndDict();
+}
+
+// Выводит словарь с объёмом памяти данных сети
+template <typename Output>
+void GetMemoryInfo(const RequestHandler& request_handler, const Dict& memory_request, Output& output) {
+    const size_t catalogue = request_handler.GetCatalogueMemoryUsage();
+    const size_t router = request_handler.GetRouterMemoryUsage();
+    output.StartDict()
+              .Key("catalogue_kb"s).Value(static_cast<int>(catalogue / 1024))
+              .Key("request_id"s).Value(memory_request.at("id"sv).AsInt())
+              .Key("router_kb"s).Value(static_cast<int>(router / 1024))
+              .Key("total_kb"s).Value(static_cast<int>((catalogue + router) / 1024))
+          .EndDict();
+}
+
+// Выводит в output ответ на запрос из "stat_requests"; для запроса без типа ничего не выводит и возвращает false
+template <typename Output>
+bool ApplyStatRequest(const RequestHandler& request_handler, const Dict& request_info, Output& output) {
+    const std::string_view type = request_info.at("type"sv).AsString();
+    if(type == "Bus"sv) {
+        GetBusInfo(request_handler.GetTransportCatalogue(), request_info, output);
+    } else if(type == "Stop"sv) {
+        GetStopInfo(request_handler.GetTransportCatalogue(), request_info, output);
+    } else if(type == "NearestStops"sv) {
+        GetNearestStops(request_handler.GetTransportCatalogue(), request_info, output);
+    } else if(type == "StopsInBox"sv) {
+        GetStopsInBox(request_handler.GetTransportCatalogue(), request_info, output);
+    } else if(type == "StopSearch"sv) {
+        GetStopSearch(request_handler.GetTransportCatalogue(), request_info, output);
+    } else if(type == "Map"sv) {
+        GetRoutesMap(request_handler, request_info, output);
+    } else if(type == "Route"sv) {
+        GetRouteInfo(request_handler, request_info, output);
+    } else if(type == "Memory"sv) {
+        GetMemoryInfo(request_handler, request_info, output);
+    } else {
+        return false;
     }
-    return builder.EndArray()
-                .Key("total_time"s).Value(route->total_time)
-            .EndDict()
-            .Build();
+    return true;
 }
+
+// Собирает документ из событий потокового разбора: значения ключей верхнего уровня сохраняются
+// в словарь, а элементы "stat_requests" выполняются и выводятся по одному
+class StreamHandler final : public json::Handler {
+public:
+    // start_requests получает прочитанные ключи и возвращает обработчик запросов
+    using StartRequests = std::function<RequestHandler(Dict)>;
+
+    StreamHandler(StartRequests start_requests, std::ostream& output)
+        : start_requests_(std::move(start_requests))
+        , output_(output) {
+    }
+
+    void Null() override {
+        AddNode(Node{});
+    }
+    void Bool(bool value) override {
+        AddNode(Node{value});
+    }
+    void Int(int value) override {
+        AddNode(Node{value});
+    }
+    void Double(double value) override {
+        AddNode(Node{value});
+    }
+    void String(std::string value) override {
+        AddNode(Node{std::move(value)});
+    }
+
+    void StartArray() override {
+        if(AtTopLevel() && key_ == "stat_requests"sv) {
+            request_handler_.emplace(start_requests_(std::move(dict_)));
+            writer_.emplace(output_);
+            writer_->StartArray();
+            return;
+        }
+        OpenContainer(Array{});
+    }
+
+    void EndArray() override {
+        if(containers_.empty()) {
+            writer_->EndArray();
+            writer_.reset();
+            requests_done_ = true;
+            return;
+        }
+        CloseContainer();
+    }
+
+    void StartDict() override {
+        if(!has_root_) {
+            has_root_ = true;
+            return;
+        }
+        OpenContainer(Dict{});
+    }
+
+    void Key(std::string key) override {
+        if(AtTopLevel()) {
+            if(requests_done_) {
+                throw ParsingError("\"stat_requests\" must be the last key"s);
+            }
+            if(dict_.contains(key)) {
+                throw ParsingError("Duplicate of key '"s + key + "' was found"s);
+            }
+            key_ = std::move(key);
+            return;
+        }
+        if(containers_.back().AsMap().contains(key)) {
+            throw ParsingError("Duplicate of key '"s + key + "' was found"s);
+        }
+        keys_.back() = std::move(key);
+    }
+
+    void EndDict() override {
+        if(!containers_.empty()) {
+            CloseContainer();
+        }
+    }
+
+    // выводит пустой массив ответов, если в документе не было "stat_requests"
+    void Finish() {
+        if(!requests_done_) {
+            Writer(output_).StartArray().EndArray();
+        }
+    }
+
+private:
+    // true между ключами словаря верхнего уровня
+    bool AtTopLevel() const {
+        return containers_.empty() && !writer_;
+    }
+
+    void OpenContainer(Node container) {
+        if(!has_root_) {
+            throw std::logic_error("The root of the document must be a dictionary"s);
+        }
+        containers_.push_back(std::move(container));
+        keys_.emplace_back();
+    }
+
+    void CloseContainer() {
+        Node container = std::move(containers_.back());
+        containers_.pop_back();
+        keys_.pop_back();
+        AddNode(std::move(container));
+    }
+
+    // добавляет значение в текущий массив или словарь либо завершает значение верхнего уровня
+    void AddNode(Node node) {
+        if(!has_root_) {
+            throw std::logic_error("The root of the document must be a dictionary"s);
+        }
+        if(containers_.empty()) {
+            FinishValue(std::move(node));
+            return;
+        }
+        auto& container = containers_.back().GetValue();
+        if(auto* array = std::get_if<Array>(&container)) {
+            array->push_back(std::move(node));
+        } else {
+            std::get<Dict>(container).emplace(std::move(keys_.back()), std::move(node));
+        }
+    }
+
+    void FinishValue(Node node) {
+        if(!writer_) {
+            if(key_ == "stat_requests"sv) {
+                throw std::logic_error("\"stat_requests\" must be an array"s);
+            }
+            dict_.emplace(std::move(key_), std::move(node));
+            return;
+        }
+        // запрос удаляется сразу после вывода ответа
+        ApplyStatRequest(*request_handler_, node.AsMap(), *writer_);
+    }
+
+    StartRequests start_requests_;
+    std::ostream& output_;
+
+    bool has_root_ = false;
+    Dict dict_;
+    std::string key_;
+    // незавершённые массивы и словари внутри текущего значения и ключи их следующих элементов
+    std::vector<Node> containers_;
+    std::vector<std::string> keys_;
+
+    std::optional<RequestHandler> request_handler_;
+    std::optional<Writer> writer_;
+    bool requests_done_ = false;
+};
 }  // namespace
 
-JsonReader::JsonReader(std::istream& input) {
-    dict_ = json::Load(input).GetRoot().AsMap();
+JsonReader::JsonReader(std::istream& input)
+    : document_(json::Load(input)) {
+    // корень документа должен быть словарём
+    GetDict();
+}
+
+JsonReader::JsonReader(json::Dict dict)
+    : document_(Node{std::move(dict)}) {
 }
 
-// Заполняем каталог остановками с координатами
-void JsonReader::FillStops(TransportCatalogue& catalogue, const Array& array) const {
+void JsonReader::ProcessStream(std::istream& input,
+    const std::function<std::shared_ptr<const snapshot::DataSnapshot>(const JsonReader&)>& prepare,
+    std::ostream& output) {
+    StreamHandler handler([&prepare](Dict dict) {
+        return RequestHandler(prepare(JsonReader(std::move(dict))));
+    }, output);
+    json::Parse(input, handler);
+    handler.Finish();
+}
+
+// Возвращает остановки с координатами
+std::vector<Stop> JsonReader::ReadStops(const Array& array) const {
+    std::vector<Stop> stops;
     for(const auto& item : array) {
         const auto& item_info = item.AsMap();
-        if(item_info.at("type"s).AsString() == "Stop"s) {
-            catalogue.AddStop({item_info.at("name"s).AsString(), 
-                {item_info.at("latitude"s).AsDouble(), item_info.at("longitude"s).AsDouble()}});
+        if(item_info.at("type"sv).AsString() == "Stop"sv) {
+            stops.push_back({item_info.at("name"sv).AsString(), 
+                geo::Coordinates{item_info.at("latitude"sv).AsDouble(), item_info.at("longitude"sv).AsDouble()}});
         }
     }
+    return stops;
 }
 
-// Заполняем каталог расстояниями между остановок
-void JsonReader::FillDistancesBetweenStops(TransportCatalogue& catalogue, const Array& array) const {
+// Возвращает расстояния между остановок
+std::vector<DistanceDescription> JsonReader::ReadDistancesBetweenStops(const Array& array) const {
+    std::vector<DistanceDescription> distances;
     for(const auto& item : array) {
         const auto& item_info = item.AsMap();
-        if(item_info.at("type"s).AsString() == "Stop"s) {
-            for(const auto& [to, distance] : item_info.at("road_distances"s).AsMap()) {
-                catalogue.AddDistanceBetweenStops(item_info.at("name"s).AsString(), 
-                    to, distance.AsInt());
+        if(item_info.at("type"sv).AsString() == "Stop"sv) {
+            for(const auto& [to, distance] : item_info.at("road_distances"sv).AsMap()) {
+                distances.push_back({item_info.at("name"sv).AsString(), to, static_cast<size_t>(distance.AsInt())});
             }
         }
     }
+    return distances;
 }
 
-// Заполняем каталог автобусными маршрутами
-void JsonReader::FillBusRoutes(TransportCatalogue& catalogue, const Array& array) const {
+// Возвращает автобусные маршруты
+std::vector<BusDescription> JsonReader::ReadBusRoutes(const Array& array) const {
+    std::vector<BusDescription> buses;
     for(const auto& item : array) {
         const auto& item_info = item.AsMap();
-        if(item_info.at("type"s).AsString() == "Bus"s) {
-            Bus bus{item_info.at("name"s).AsString(), {}, item_info.at("is_roundtrip"s).AsBool()};
+        if(item_info.at("type"sv).AsString() == "Bus"sv) {
+            BusDescription bus{item_info.at("name"sv).AsString(), {}, item_info.at("is_roundtrip"sv).AsBool()};
                 
-            const auto& stops = item_info.at("stops"s).AsArray();
-            bus.stops.reserve(bus.is_roundtrip ? stops.size() : stops.size() * 2 - 1);
-
+            // обратный путь некольцевого маршрута справочник не хранит, см. domain::RouteStops
+            const auto& stops = item_info.at("stops"sv).AsArray();
+            bus.stops.reserve(stops.size());
             for(const auto& stop : stops) {
-                bus.stops.push_back(catalogue.GetStop(stop.AsString()));
+                bus.stops.push_back(stop.AsString());
             }
-            // Разворачиваем некольцевой маршрут
-            if(bus.is_roundtrip == false) {
-                std::copy(bus.stops.rbegin() + 1, bus.stops.rend(), std::back_inserter(bus.stops));
-            }
-            catalogue.AddBus(bus);
+            buses.push_back(std::move(bus));
         }
     }
+    return buses;
 }
 
 // заполняет весь каталог данными
-void JsonReader::FillTransportCatalogue(TransportCatalogue& catalogue) const {
-    if(dict_.contains("base_requests"s)) {
-        const auto& array = dict_.at("base_requests"s).AsArray();
-        FillStops(catalogue, array);  // Заполняем каталог остановками с координатами
-        FillDistancesBetweenStops(catalogue, array);  // Заполняем каталог расстояниями между остановок
-        FillBusRoutes(catalogue, array);// Заполняем каталог автобусными маршрутами
+void JsonReader::FillTransportCatalogue(TransportCatalogue& catalogue, std::string_view network) const {
+    const auto& dict = GetNetworkDict(network);
+    if(dict.contains("base_requests"sv)) {
+        const auto& array = dict.at("base_requests"sv).AsArray();
+        catalogue.AddBulk(ReadStops(array), ReadDistancesBetweenStops(array), ReadBusRoutes(array));
     }
 }
 
 // выводит в output результаты запросов "stat_requests"
 void JsonReader::ApplyStatRequests(const RequestHandler& request_handler, std::ostream& output) const {
-    Builder json_builder{};
+    // ответы выводятся по мере выполнения запросов
+    Writer writer(output);
+    writer.StartArray();
+    if(GetDict().contains("stat_requests"sv)) {
+        for(const auto& item : GetDict().at("stat_requests"sv).AsArray()) {
+            ApplyStatRequest(request_handler, item.AsMap(), writer);
+        }
+    }
+    writer.EndArray();
+}
 
-    if(dict_.contains("stat_requests"s)) {
-        const auto& array = dict_.at("stat_requests"s).AsArray();
-        json_builder.StartArray();
-        for(const auto& item : array) {
+// выводит в output результаты запросов "stat_requests" к нескольким сетям
+void JsonReader::ApplyStatRequests(const snapshot::NetworkRegistry& networks, threads::ThreadPool& pool,
+                                   std::ostream& output) const {
+    std::vector<std::future<std::optional<Node>>> responses;
+    if(GetDict().contains("stat_requests"sv)) {
+        for(const auto& item : GetDict().at("stat_requests"sv).AsArray()) {
             const auto& request_info = item.AsMap();
-            if(request_info.at("type"s).AsString().empty()) {
-                continue;
-            }
-            if(request_info.at("type"s).AsString() == "Bus"s) {
-                json_builder.Value(GetBusInfo(request_handler.GetTransportCatalogue(), request_info).GetValue());
-                continue;
-            }
-            if(request_info.at("type"s).AsString() == "Stop"s) {
-                json_builder.Value(GetStopInfo(request_handler.GetTransportCatalogue(), request_info).GetValue());
-                continue;
-            }
-            if(request_info.at("type"s).AsString() == "Map"s) {
-                json_builder.Value(GetRoutesMap(request_handler, request_info).GetValue());
-                continue;
-            }
-            if(request_info.at("type"s).AsString() == "Route"s) {
-                json_builder.Value(GetRouteInfo(request_handler, request_info).GetValue());
-            }
+            responses.push_back(pool.Submit([&networks, &request_info]() -> std::optional<Node> {
+                const auto network = request_info.contains("network"sv)
+                    ? networks.Get(request_info.at("network"sv).AsString()) : networks.Get(""sv);
+                Builder builder{};
+                if(!network) {
+                    WriteError(builder, request_info.at("id"sv).AsInt(), "unknown network"s);
+                    return builder.Build();
+                }
+                // запрос удерживает версию данных сети до конца обработки
+                if(!ApplyStatRequest(RequestHandler(network), request_info, builder)) {
+                    return std::nullopt;
+                }
+                return builder.Build();
+            }));
+        }
+    }
+
+    // ответы выводятся в порядке запросов по мере готовности
+    Writer writer(output);
+    writer.StartArray();
+    for(auto& response : responses) {
+        if(auto node = response.get()) {
+            writer.Value(node->GetValue());
         }
     }
-    Print(json::Document{json_builder.EndArray().Build()}, output);
+    writer.EndArray();
 }
 
 // возвращает настройки для отрисовки маршрутов
-renderer::detail::RenderSettings JsonReader::GetRenderSettings() const {
-    const auto& render_settings = dict_.at("render_settings"s).AsMap();
-
-    return {.width = render_settings.at("width"s).AsDouble(),
-            .height = render_settings.at("height"s).AsDouble(),
-            .padding = render_settings.at("padding"s).AsDouble(),
-            .line_width = render_settings.at("line_width"s).AsDouble(),
-            .stop_radius = render_settings.at("stop_radius"s).AsDouble(),
-            .bus_label_font_size = render_settings.at("bus_label_font_size"s).AsInt(),
-            .bus_label_offset{render_settings.at("bus_label_offset"s).AsArray()[0].AsDouble(),
-                render_settings.at("bus_label_offset"s).AsArray()[1].AsDouble()},
-            .stop_label_font_size = render_settings.at("stop_label_font_size"s).AsInt(),
-            .stop_label_offset{render_settings.at("stop_label_offset"s).AsArray()[0].AsDouble(),
-                render_settings.at("stop_label_offset"s).AsArray()[1].AsDouble()},
-            .underlayer_color = NodeToColor(render_settings.at("underlayer_color"s)),
-            .underlayer_width = render_settings.at("underlayer_width"s).AsDouble(),
-            .color_palette = ArrayToColorVector(render_settings.at("color_palette"s).AsArray())};
+renderer::detail::RenderSettings JsonReader::GetRenderSettings(std::string_view network) const {
+    const auto& render_settings = GetNetworkDict(network).at("render_settings"sv).AsMap();
+
+    return {.width = render_settings.at("width"sv).AsDouble(),
+            .height = render_settings.at("height"sv).AsDouble(),
+            .padding = render_settings.at("padding"sv).AsDouble(),
+            .line_width = render_settings.at("line_width"sv).AsDouble(),
+            .stop_radius = render_settings.at("stop_radius"sv).AsDouble(),
+            .bus_label_font_size = render_settings.at("bus_label_font_size"sv).AsInt(),
+            .bus_label_offset{render_settings.at("bus_label_offset"sv).AsArray()[0].AsDouble(),
+                render_settings.at("bus_label_offset"sv).AsArray()[1].AsDouble()},
+            .stop_label_font_size = render_settings.at("stop_label_font_size"sv).AsInt(),
+            .stop_label_offset{render_settings.at("stop_label_offset"sv).AsArray()[0].AsDouble(),
+                render_settings.at("stop_label_offset"sv).AsArray()[1].AsDouble()},
+            .underlayer_color = NodeToColor(render_settings.at("underlayer_color"sv)),
+            .underlayer_width = render_settings.at("underlayer_width"sv).AsDouble(),
+            .color_palette = ArrayToColorVector(render_settings.at("color_palette"sv).AsArray())};
 }
 
 // возвращает настройки для построения маршрутов
-router::RoutingSettings JsonReader::GetRoutingSettings() const {
-    const auto& routing_settings = dict_.at("routing_settings"s).AsMap();
+router::RoutingSettings JsonReader::GetRoutingSettings(std::string_view network) const {
+    const auto& routing_settings = GetNetworkDict(network).at("routing_settings"sv).AsMap();
 
     constexpr double SpeedToMInMinuteKoef = 100 / 6.0; // коэффициент для перевода скорости из км/ч в м/мин
     auto convert_speed = [SpeedToMInMinuteKoef](int km_per_hour) {
         return km_per_hour * SpeedToMInMinuteKoef;
     };
-    return {.bus_velocity = convert_speed(routing_settings.at("bus_velocity"s).AsInt()),
-            .bus_waiting_time = routing_settings.at("bus_wait_time"s).AsInt()};
+    return {.bus_velocity = convert_speed(routing_settings.at("bus_velocity"sv).AsInt()),
+            .bus_waiting_time = routing_settings.at("bus_wait_time"sv).AsInt()};
+}
+
+// возвращает настройки сохранения снимка справочника
+serialization::SerializationSettings JsonReader::GetSerializationSettings() const {
+    const auto& serialization_settings = GetDict().at("serialization_settings"sv).AsMap();
+    return {.file = serialization_settings.at("file"sv).AsString()};
+}
+
+// возвращает названия сетей из словаря "networks"
+std::vector<std::string> JsonReader::GetNetworks() const {
+    std::vector<std::string> networks;
+    if(GetDict().contains("networks"sv)) {
+        for(const auto& [name, network] : GetDict().at("networks"sv).AsMap()) {
+            networks.push_back(name);
+        }
+    }
+    return networks;
+}
+
+// возвращает словарь с данными сети
+const json::Dict& JsonReader::GetDict() const {
+    return document_.GetRoot().AsMap();
+}
+
+const json::Dict& JsonReader::GetNetworkDict(std::string_view network) const {
+    if(network.empty()) {
+        return GetDict();
+    }
+    return GetDict().at("networks"sv).AsMap().at(network).AsMap();
 }
 }// namespace json_reader
 }// namespace catalogue
\ No newline at end of file
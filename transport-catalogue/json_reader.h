@@ -1,7 +1,13 @@
 #pragma once
 
 #include "json.h"
+#include "network_registry.h"
 #include "request_handler.h"
+#include "serialization.h"
+#include "thread_pool.h"
+
+#include <functional>
+#include <memory>
 
 namespace catalogue {
 namespace json_reader {
@@ -10,27 +16,57 @@ class JsonReader {
 public:
     explicit JsonReader(std::istream& input);
 
+    // Потоковая обработка: документ разбирается по мере чтения из input. Когда начинается массив
+    // "stat_requests", prepare получает JsonReader с прочитанными ключами и возвращает версию данных,
+    // затем каждый запрос выполняется сразу после разбора, его ответ выводится в output и запрос
+    // удаляется. Ключ "stat_requests" должен быть последним в документе
+    static void ProcessStream(std::istream& input,
+        const std::function<std::shared_ptr<const snapshot::DataSnapshot>(const JsonReader&)>& prepare,
+        std::ostream& output);
+
+    // Параметр network - название сети из словаря "networks"; пустое название - данные верхнего уровня
+
     // заполняет каталог данными
-    void FillTransportCatalogue(TransportCatalogue& catalogue) const;
+    void FillTransportCatalogue(TransportCatalogue& catalogue, std::string_view network = {}) const;
 
     // выводит в output результаты запросов "stat_requests"
     void ApplyStatRequests(const RequestHandler& request_handler, std::ostream& output) const;
+
+    // выводит в output результаты запросов "stat_requests" к нескольким сетям: сеть запроса задаёт
+    // ключ "network", запросы выполняются параллельно в pool, ответы выводятся в порядке запросов
+    void ApplyStatRequests(const snapshot::NetworkRegistry& networks, threads::ThreadPool& pool,
+                           std::ostream& output) const;
     
     // возвращает настройки для отрисовки маршрутов
-    renderer::detail::RenderSettings GetRenderSettings() const;
+    renderer::detail::RenderSettings GetRenderSettings(std::string_view network = {}) const;
 
     // возвращает настройки для построения маршрутов
-    router::RoutingSettings GetRoutingSettings() const;
+    router::RoutingSettings GetRoutingSettings(std::string_view network = {}) const;
+
+    // возвращает названия сетей из словаря "networks" (пусто, если сеть одна)
+    std::vector<std::string> GetNetworks() const;
+
+    // возвращает настройки сохранения снимка справочника
+    serialization::SerializationSettings GetSerializationSettings() const;
 
 private:
-    // Заполняем каталог остановками с координатами
-    void FillStops(TransportCatalogue& catalogue, const json::Array& array) const;
-    // Заполняем каталог расстояниями между остановок
-    void FillDistancesBetweenStops(TransportCatalogue& catalogue, const json::Array& array) const;
-    // Заполняем каталог автобусными маршрутами
-    void FillBusRoutes(TransportCatalogue& catalogue, const json::Array& array) const;
-
-    json::Dict dict_;
+    explicit JsonReader(json::Dict dict);
+
+    // возвращает словарь с данными сети
+    const json::Dict& GetNetworkDict(std::string_view network) const;
+
+    // Возвращает остановки с координатами
+    std::vector<Stop> ReadStops(const json::Array& array) const;
+    // Возвращает расстояния между остановок
+    std::vector<DistanceDescription> ReadDistancesBetweenStops(const json::Array& array) const;
+    // Возвращает автобусные маршруты
+    std::vector<BusDescription> ReadBusRoutes(const json::Array& array) const;
+
+    // словарь верхнего уровня
+    const json::Dict& GetDict() const;
+
+    // документ хранится целиком: его узлы размещены в арене документа
+    json::Document document_;
 };
 
 }// namespace json_reader
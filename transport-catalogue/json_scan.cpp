@@ -0,0 +1,175 @@
+#include "json_scan.h"
+
+#if defined(__GNUC__) && defined(__SSE2__)
+#include <immintrin.h>
+#define JSON_SIMD_KERNELS
+#endif
+
+namespace json {
+namespace scan {
+
+namespace {
+
+// Для каждого вида поиска: проверка одного символа и маски совпадений в блоках 16 и 32 байт
+// (бит i маски установлен, если i-й байт блока подходит)
+
+struct StringSpecial {
+    static bool Match(char c) {
+        return c == '"' || c == '\\' || c == '\n' || c == '\r';
+    }
+#ifdef JSON_SIMD_KERNELS
+    static unsigned Mask(__m128i block) {
+        const __m128i quote = _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('"')),
+                                           _mm_cmpeq_epi8(block, _mm_set1_epi8('\\')));
+        const __m128i line = _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('\n')),
+                                          _mm_cmpeq_epi8(block, _mm_set1_epi8('\r')));
+        return static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(quote, line)));
+    }
+    __attribute__((target("avx2")))
+    static unsigned Mask(__m256i block) {
+        const __m256i quote = _mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('"')),
+                                              _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\\')));
+        const __m256i line = _mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('\n')),
+                                             _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\r')));
+        return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_or_si256(quote, line)));
+    }
+#endif
+};
+
+struct NotSpace {
+    static bool Match(char c) {
+        return c != ' ' && (c < '\t' || c > '\r');
+    }
+#ifdef JSON_SIMD_KERNELS
+    // '\t'..'\r' - подряд идущие коды: после вычитания '\t' они и только они не больше 4
+    static unsigned Mask(__m128i block) {
+        const __m128i shifted = _mm_sub_epi8(block, _mm_set1_epi8('\t'));
+        const __m128i control = _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8(4)), shifted);
+        const __m128i space = _mm_or_si128(control, _mm_cmpeq_epi8(block, _mm_set1_epi8(' ')));
+        return ~static_cast<unsigned>(_mm_movemask_epi8(space)) & 0xFFFFu;
+    }
+    __attribute__((target("avx2")))
+    static unsigned Mask(__m256i block) {
+        const __m256i shifted = _mm256_sub_epi8(block, _mm256_set1_epi8('\t'));
+        const __m256i control = _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, _mm256_set1_epi8(4)), shifted);
+        const __m256i space = _mm256_or_si256(control, _mm256_cmpeq_epi8(block, _mm256_set1_epi8(' ')));
+        return ~static_cast<unsigned>(_mm256_movemask_epi8(space));
+    }
+#endif
+};
+
+struct Escaped {
+    static bool Match(char c) {
+        return c == '"' || c == '\\' || c == '\n' || c == '\r' || c == '\t';
+    }
+#ifdef JSON_SIMD_KERNELS
+    static unsigned Mask(__m128i block) {
+        return StringSpecial::Mask(block)
+            | static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8('\t'))));
+    }
+    __attribute__((target("avx2")))
+    static unsigned Mask(__m256i block) {
+        return StringSpecial::Mask(block)
+            | static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('\t'))));
+    }
+#endif
+};
+
+template <typename Kind>
+const char* FindScalar(const char* begin, const char* end) {
+    while(begin != end && !Kind::Match(*begin)) {
+        ++begin;
+    }
+    return begin;
+}
+
+#ifdef JSON_SIMD_KERNELS
+template <typename Kind>
+const char* FindSse2(const char* begin, const char* end) {
+    for(; end - begin >= 16; begin += 16) {
+        if(const unsigned mask = Kind::Mask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(begin)))) {
+            return begin + __builtin_ctz(mask);
+        }
+    }
+    return FindScalar<Kind>(begin, end);
+}
+
+template <typename Kind>
+__attribute__((target("avx2")))
+const char* FindAvx2(const char* begin, const char* end) {
+    for(; end - begin >= 32; begin += 32) {
+        if(const unsigned mask = Kind::Mask(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin)))) {
+            return begin + __builtin_ctz(mask);
+        }
+    }
+    return FindSse2<Kind>(begin, end);
+}
+
+bool HasAvx2() {
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    return has_avx2;
+}
+#endif
+
+// ядро, которое выбирается для AUTO
+Kernel GetBestKernel() {
+#ifdef JSON_SIMD_KERNELS
+    return HasAvx2() ? Kernel::AVX2 : Kernel::SSE2;
+#else
+    return Kernel::SCALAR;
+#endif
+}
+
+template <typename Kind>
+const char* Find(const char* begin, const char* end, Kernel kernel) {
+    // пустой участок (соседние скобки, пустая строка) обходится без векторных загрузок
+    if(begin == end || Kind::Match(*begin)) {
+        return begin;
+    }
+    if(kernel == Kernel::AUTO || !IsSupported(kernel)) {
+        kernel = GetBestKernel();
+    }
+    switch(kernel) {
+#ifdef JSON_SIMD_KERNELS
+    case Kernel::AVX2:
+        return FindAvx2<Kind>(begin, end);
+    case Kernel::SSE2:
+        return FindSse2<Kind>(begin, end);
+#endif
+    default:
+        return FindScalar<Kind>(begin, end);
+    }
+}
+
+}  // namespace
+
+// доступно ли ядро на этом процессоре
+bool IsSupported(Kernel kernel) {
+    switch(kernel) {
+#ifdef JSON_SIMD_KERNELS
+    case Kernel::AVX2:
+        return HasAvx2();
+#else
+    case Kernel::SSE2:
+    case Kernel::AVX2:
+        return false;
+#endif
+    default:
+        return true;
+    }
+}
+
+const char* FindStringSpecial(const char* begin, const char* end, Kernel kernel) {
+    return Find<StringSpecial>(begin, end, kernel);
+}
+
+const char* SkipSpaces(const char* begin, const char* end, Kernel kernel) {
+    return Find<NotSpace>(begin, end, kernel);
+}
+
+const char* FindEscaped(const char* begin, const char* end, Kernel kernel) {
+    return Find<Escaped>(begin, end, kernel);
+}
+
+}  // namespace scan
+}  // namespace json
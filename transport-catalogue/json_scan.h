@@ -0,0 +1,33 @@
+#pragma once
+
+namespace json {
+namespace scan {
+
+// Поиск символов при разборе и выводе JSON. На x86 буфер просматривается блоками
+// по 32 байта (AVX2, если процессор его поддерживает) или 16 байт (SSE2), остаток - по байту.
+// Все функции возвращают end, если подходящего символа нет
+
+// ядро поиска; AUTO выбирает лучшее доступное, недоступное ядро заменяется выбранным для AUTO.
+// Все ядра дают одинаковый результат, явный выбор нужен тестам и замерам
+enum class Kernel {
+    AUTO,
+    SCALAR,
+    SSE2,
+    AVX2
+};
+
+// доступно ли ядро на этом процессоре
+bool IsSupported(Kernel kernel);
+
+// первый символ, завершающий простой участок строки: '"', '\\', '\n' или '\r'
+const char* FindStringSpecial(const char* begin, const char* end, Kernel kernel = Kernel::AUTO);
+
+// первый символ, не являющийся пробельным (' ', '\t', '\n', '\v', '\f', '\r')
+const char* SkipSpaces(const char* begin, const char* end, Kernel kernel = Kernel::AUTO);
+
+// первый символ, который при выводе заменяется escape-последовательностью:
+// '"', '\\', '\n', '\r' или '\t'
+const char* FindEscaped(const char* begin, const char* end, Kernel kernel = Kernel::AUTO);
+
+}  // namespace scan
+}  // namespace json
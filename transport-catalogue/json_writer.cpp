@@ -0,0 +1,195 @@
+#include "json_writer.h"
+#include "json_scan.h"
+
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std::literals;
+
+namespace json {
+
+Writer::Writer(std::ostream& output) : output_{output} {
+    buffer_.reserve(BUFFER_SIZE);
+}
+
+Writer::~Writer() {
+    Flush();
+}
+
+// Выводит ключ словаря; как и Print, ключи выводятся с отступом самого словаря
+Writer::KeyContext Writer::Key(std::string_view key) {
+    if(levels_.empty() || !levels_.back().is_dict || levels_.back().has_key) {
+        throw std::logic_error("The key is expected after the \"StartDict()\" or \"Value()\" methods"s);
+    }
+    Level& level = levels_.back();
+    NextItem(level);
+    WriteIndent(levels_.size() - 1);
+    WriteString(key);
+    buffer_ += ": "sv;
+    level.has_key = true;
+    return BaseContext{*this};
+}
+
+// Выводит значение: элемент массива, значение для ключа или весь документ
+Writer::BaseContext Writer::Value(const Node::Value& value) {
+    BeforeValue();
+    std::visit([this](const auto& value) {
+        using Type = std::decay_t<decltype(value)>;
+        if constexpr(std::is_same_v<Type, std::nullptr_t>) {
+            buffer_ += "null"sv;
+        } else if constexpr(std::is_same_v<Type, bool>) {
+            buffer_ += value ? "true"sv : "false"sv;
+        } else if constexpr(std::is_same_v<Type, int>) {
+            char chars[16];
+            buffer_.append(chars, std::to_chars(chars, chars + sizeof(chars), value).ptr);
+        } else if constexpr(std::is_same_v<Type, double>) {
+            // кратчайшая запись, которая читается обратно в то же самое значение;
+            // "-0" читается как целый 0, поэтому отрицательный ноль выводится с дробной частью
+            if(value == 0 && std::signbit(value)) {
+                buffer_ += "-0.0"sv;
+            } else {
+                char chars[32];
+                buffer_.append(chars, std::to_chars(chars, chars + sizeof(chars), value).ptr);
+            }
+        } else if constexpr(std::is_same_v<Type, std::string> || std::is_same_v<Type, std::string_view>) {
+            WriteString(value);
+        } else if constexpr(std::is_same_v<Type, Array>) {
+            OpenLevel('[', false);
+            for(const Node& node : value) {
+                Value(node.GetValue());
+            }
+            EndArray();
+        } else {
+            OpenLevel('{', true);
+            for(const auto& [key, node] : value) {
+                Key(key);
+                Value(node.GetValue());
+            }
+            EndDict();
+        }
+    }, value);
+    FlushIfFull();
+    return BaseContext{*this};
+}
+
+Writer::DictContext Writer::StartDict() {
+    BeforeValue();
+    OpenLevel('{', true);
+    return BaseContext{*this};
+}
+
+Writer::ArrayContext Writer::StartArray() {
+    BeforeValue();
+    OpenLevel('[', false);
+    return BaseContext{*this};
+}
+
+Writer::BaseContext Writer::EndDict() {
+    if(levels_.empty() || !levels_.back().is_dict || levels_.back().has_key) {
+        throw std::logic_error("The unfinished dictionary is expected before the \"EndDict()\" method"s);
+    }
+    CloseLevel('}');
+    return BaseContext{*this};
+}
+
+Writer::BaseContext Writer::EndArray() {
+    if(levels_.empty() || levels_.back().is_dict) {
+        throw std::logic_error("The unfinished array is expected before the \"EndArray()\" method"s);
+    }
+    CloseLevel(']');
+    return BaseContext{*this};
+}
+
+void Writer::Flush() {
+    output_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    buffer_.clear();
+}
+
+void Writer::BeforeValue() {
+    if(levels_.empty()) {
+        if(has_root_) {
+            throw std::logic_error("Attempt to modify a completed JSON object"s);
+        }
+        has_root_ = true;
+        return;
+    }
+    Level& level = levels_.back();
+    if(level.is_dict) {
+        if(!level.has_key) {
+            throw std::logic_error("Incorrect method call context"s);
+        }
+        level.has_key = false;
+        return;
+    }
+    NextItem(level);
+    WriteIndent(levels_.size());
+}
+
+void Writer::NextItem(Level& level) {
+    if(level.is_first) {
+        level.is_first = false;
+    } else {
+        buffer_ += ",\n"sv;
+    }
+}
+
+void Writer::OpenLevel(char bracket, bool is_dict) {
+    buffer_ += bracket;
+    buffer_ += '\n';
+    levels_.push_back({is_dict});
+}
+
+void Writer::CloseLevel(char bracket) {
+    levels_.pop_back();
+    buffer_ += '\n';
+    WriteIndent(levels_.size());
+    buffer_ += bracket;
+    FlushIfFull();
+}
+
+// Отступ - 4 пробела на уровень вложенности
+void Writer::WriteIndent(size_t level) {
+    buffer_.append(level * 4, ' ');
+}
+
+void Writer::WriteString(std::string_view str) {
+    buffer_ += '"';
+    const char* pos = str.data();
+    const char* const end = pos + str.size();
+    while(pos != end) {
+        // символы без экранирования копируются куском
+        const char* run_end = scan::FindEscaped(pos, end);
+        buffer_.append(pos, run_end);
+        if(run_end == end) {
+            break;
+        }
+        pos = run_end + 1;
+        switch(*run_end) {
+            case '\n':
+                buffer_ += "\\n"sv;
+                break;
+            case '\r':
+                buffer_ += "\\r"sv;
+                break;
+            case '\t':
+                buffer_ += "\\t"sv;
+                break;
+            case '"':
+                buffer_ += "\\\""sv;
+                break;
+            case '\\':
+                buffer_ += "\\\\"sv;
+                break;
+        }
+    }
+    buffer_ += '"';
+}
+
+void Writer::FlushIfFull() {
+    if(buffer_.size() >= BUFFER_SIZE) {
+        Flush();
+    }
+}
+
+}  // namespace json
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "json.h"
+
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace json {
+
+// Потоковый вывод JSON с тем же интерфейсом, что у Builder: значения сразу форматируются в буфер,
+// который сбрасывается в поток блоками, дерево Node не строится. Формат совпадает с Print
+class Writer {
+private:
+    // Вспомогательные классы для возврата допустимых методов, как у Builder
+    class BaseContext;
+    class DictContext;
+    class ArrayContext;
+    class KeyContext;
+
+public:
+    explicit Writer(std::ostream& output);
+
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    // сбрасывает в поток остаток буфера
+    ~Writer();
+
+    KeyContext Key(std::string_view key);
+    BaseContext Value(const Node::Value& value);
+    DictContext StartDict();
+    ArrayContext StartArray();
+    BaseContext EndDict();
+    BaseContext EndArray();
+
+    // сбрасывает буфер в поток
+    void Flush();
+
+private:
+    static constexpr size_t BUFFER_SIZE = 64 * 1024;
+
+    // незавершённый массив или словарь
+    struct Level {
+        bool is_dict = false;
+        bool is_first = true;  // ещё не выведено ни одного элемента
+        bool has_key = false;  // ключ словаря выведен, ожидается значение
+    };
+
+    // Проверяет контекст и выводит разделитель и отступ перед новым значением
+    void BeforeValue();
+    // Выводит разделитель перед очередным элементом массива или словаря
+    void NextItem(Level& level);
+    void OpenLevel(char bracket, bool is_dict);
+    void CloseLevel(char bracket);
+
+    void WriteIndent(size_t level);
+    void WriteString(std::string_view str);
+    void FlushIfFull();
+
+    std::ostream& output_;
+    std::string buffer_;
+    std::vector<Level> levels_;
+    bool has_root_ = false;
+
+    class BaseContext {
+    public:
+        BaseContext(Writer& writer) : writer_{writer} {}
+
+        KeyContext Key(std::string_view key) {
+            return writer_.Key(key);
+        }
+        BaseContext Value(const Node::Value& value) {
+            return writer_.Value(value);
+        }
+        DictContext StartDict() {
+            return writer_.StartDict();
+        }
+        ArrayContext StartArray() {
+            return writer_.StartArray();
+        }
+        BaseContext EndDict() {
+            return writer_.EndDict();
+        }
+        BaseContext EndArray() {
+            return writer_.EndArray();
+        }
+
+    private:
+        Writer& writer_;
+    };
+
+    class DictContext : public BaseContext {
+    public:
+        DictContext(BaseContext base) : BaseContext{base} {}
+
+        BaseContext Value(const Node::Value&) = delete;
+        DictContext StartDict() = delete;
+        ArrayContext StartArray() = delete;
+        BaseContext EndArray() = delete;
+    };
+
+    class ArrayContext : public BaseContext {
+    public:
+        ArrayContext(BaseContext base) : BaseContext{base} {}
+
+        ArrayContext Value(const Node::Value& value) {
+            return BaseContext::Value(value);
+        }
+        KeyContext Key(std::string_view) = delete;
+        BaseContext EndDict() = delete;
+    };
+
+    class KeyContext : public BaseContext {
+    public:
+        KeyContext(BaseContext base) : BaseContext{base} {}
+
+        DictContext Value(const Node::Value& value) {
+            return BaseContext::Value(value);
+        }
+        KeyContext Key(std::string_view key) = delete;
+        BaseContext EndDict() = delete;
+        BaseContext EndArray() = delete;
+    };
+};
+
+}  // namespace json
@@ -1,25 +1,154 @@
+#include <fstream>
+#include <future>
 #include <iostream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
 
+#include "data_snapshot.h"
 #include "json_reader.h"
+#include "network_registry.h"
 #include "request_handler.h"
+#include "serialization.h"
+#include "thread_pool.h"
 
 using namespace std;
 using namespace catalogue;
 using namespace renderer;
 using namespace router;
 
-int main() {
+namespace {
+
+void PrintUsage() {
+    cerr << "Usage: transport-catalogue [make_base|process_requests] [--lazy-stats] [--stream]\n"sv;
+}
+
+// публикует заполненный справочник как текущую версию данных и отвечает на stat_requests
+void ProcessRequests(const json_reader::JsonReader& reader, unique_ptr<TransportCatalogue> catalogue,
+                     const serialization::BaseSettings& settings) {
+    snapshot::SnapshotHolder holder;
+    holder.Publish(std::move(catalogue), settings.render_settings, settings.routing_settings, settings.router_data);
+
+    RequestHandler handler(holder.Get());
+    
+    reader.ApplyStatRequests(handler, cout);
+}
+
+// заполняет справочники всех сетей из "networks" и отвечает на stat_requests к ним;
+// загрузка сетей и запросы выполняются в общем пуле потоков
+void ProcessNetworks(const json_reader::JsonReader& reader, StatsMode stats_mode) {
+    snapshot::NetworkRegistry networks;
+    // объявлен после networks и разрушается первым: если загрузка или запрос выбросит исключение,
+    // пул дождётся оставшихся задач, пока сети, на которые они ссылаются, ещё живы
+    threads::ThreadPool pool;
+
+    vector<future<void>> loads;
+    for(const string& name : reader.GetNetworks()) {
+        auto& holder = networks.AddNetwork(name);
+        loads.push_back(pool.Submit([&reader, &holder, name, stats_mode] {
+            auto catalogue = make_unique<TransportCatalogue>(stats_mode);
+            reader.FillTransportCatalogue(*catalogue, name);
+            holder.Publish(std::move(catalogue), reader.GetRenderSettings(name), reader.GetRoutingSettings(name));
+        }));
+    }
+    for(auto& load : loads) {
+        load.get();
+    }
+
+    reader.ApplyStatRequests(networks, pool, cout);
+}
+
+// разбирает запросы из input по мере чтения: справочник заполняется (или загружается из снимка)
+// перед началом "stat_requests", каждый запрос выполняется сразу после разбора
+void ProcessStream(istream& input, optional<string_view> mode, StatsMode stats_mode) {
+    snapshot::SnapshotHolder holder;
+    json_reader::JsonReader::ProcessStream(input, [&holder, mode, stats_mode](const json_reader::JsonReader& reader) {
+        if(!reader.GetNetworks().empty()) {
+            throw logic_error("--stream works with a single network"s);
+        }
+        auto catalogue = make_unique<TransportCatalogue>(stats_mode);
+        serialization::BaseSettings settings;
+        if(mode == "process_requests"sv) {
+            settings = serialization::Load(reader.GetSerializationSettings().file, *catalogue);
+        } else {
+            reader.FillTransportCatalogue(*catalogue);
+            settings = {reader.GetRenderSettings(), reader.GetRoutingSettings(), nullopt};
+        }
+        holder.Publish(std::move(catalogue), settings.render_settings, settings.routing_settings,
+                       settings.router_data);
+        return holder.Get();
+    }, cout);
+}
+}  // namespace
+
+// режимы работы:
+//   make_base - заполняет справочник по base_requests и сохраняет снимок в файл из serialization_settings;
+//   process_requests - загружает снимок и отвечает на stat_requests;
+//   без режима - заполнение и ответы за один запуск, в том числе для нескольких сетей из "networks";
+// с ключом --stream запросы "stat_requests" выполняются по мере чтения, без хранения всего документа
+int main(int argc, char* argv[]) {
     using namespace std::literals;
 
-    TransportCatalogue catalogue;
+    optional<string_view> mode;
+    // с ключом --lazy-stats статистика маршрутов считается только при запросах "Bus"
+    bool lazy_stats = false;
+    bool stream = false;
+    for(int i = 1; i < argc; ++i) {
+        const string_view arg = argv[i];
+        if(arg == "--lazy-stats"sv) {
+            lazy_stats = true;
+        } else if(arg == "--stream"sv) {
+            stream = true;
+        } else if(!mode && (arg == "make_base"sv || arg == "process_requests"sv)) {
+            mode = arg;
+        } else {
+            PrintUsage();
+            return 1;
+        }
+    }
+    const StatsMode stats_mode = lazy_stats ? StatsMode::LAZY : StatsMode::EAGER;
+
+    if(stream) {
+        if(mode == "make_base"sv) {
+            PrintUsage();
+            return 1;
+        }
+        ProcessStream(cin, mode, stats_mode);
+        return 0;
+    }
+
+    auto catalogue = make_unique<TransportCatalogue>(stats_mode);
     
     json_reader::JsonReader reader(cin);
-    reader.FillTransportCatalogue(catalogue);
 
-    MapRenderer renderer(reader.GetRenderSettings());
-    TransportRouter router(reader.GetRoutingSettings(), catalogue);
+    if(!reader.GetNetworks().empty()) {
+        if(mode) {
+            cerr << "make_base and process_requests work with a single network\n"sv;
+            return 1;
+        }
+        ProcessNetworks(reader, stats_mode);
+        return 0;
+    }
 
-    RequestHandler handler(catalogue, renderer, router);
-    
-    reader.ApplyStatRequests(handler, cout);
-}
\ No newline at end of file
+    if(mode == "process_requests"sv) {
+        const auto settings = serialization::Load(reader.GetSerializationSettings().file, *catalogue);
+        ProcessRequests(reader, std::move(catalogue), settings);
+        return 0;
+    }
+
+    reader.FillTransportCatalogue(*catalogue);
+    const serialization::BaseSettings settings{reader.GetRenderSettings(), reader.GetRoutingSettings(), nullopt};
+
+    if(mode == "make_base"sv) {
+        ofstream output(reader.GetSerializationSettings().file, ios::binary);
+        if(!output) {
+            cerr << "Cannot create catalogue snapshot\n"sv;
+            return 1;
+        }
+        catalogue->Freeze();
+        serialization::Save(output, *catalogue, settings);
+        return 0;
+    }
+
+    ProcessRequests(reader, std::move(catalogue), settings);
+}
@@ -18,8 +18,8 @@ MapRenderer::MapRenderer(const detail::RenderSettings& settings) : settings_{set
 }
 
 // добавляет ломаные линии маршрутов
-void MapRenderer::AddRoutePolyline(svg::Document& doc, const std::vector<const domain::Stop*>& stops,
-    const svg::Color& color, const SphereProjector& proj) const {
+void MapRenderer::AddRoutePolyline(svg::Document& doc, const TransportCatalogue& catalogue,
+    domain::RouteStops stops, const svg::Color& color, const SphereProjector& proj) const {
     
     svg::Polyline route;
 
@@ -29,16 +29,16 @@ void MapRenderer::AddRoutePolyline(svg::Document& doc, const std::vector<const d
     route.SetStrokeLineCap(svg::StrokeLineCap::ROUND);
     route.SetStrokeLineJoin(svg::StrokeLineJoin::ROUND);
     
-    for(const auto& stop : stops) {
-        route.AddPoint(proj(stop->coord));
+    for(domain::StopId stop : stops) {
+        route.AddPoint(proj(catalogue.GetStopById(stop)->coord));
     }
 
     doc.Add(route);
 }
 
 // добавляет полилинию маршрута
-void MapRenderer::AddRoutes(svg::Document& doc, const std::map<std::string_view, const domain::Bus*>& routes, 
-    const SphereProjector& proj) const {
+void MapRenderer::AddRoutes(svg::Document& doc, const TransportCatalogue& catalogue,
+    const std::map<std::string_view, const domain::Bus*>& routes, const SphereProjector& proj) const {
 
     /*auto GetNextColor = [this]( auto& color_iter) {
         auto old_iter = color_iter;
@@ -51,14 +51,14 @@ void MapRenderer::AddRoutes(svg::Document& doc, const std::map<std::string_view,
 
     auto iter_color = settings_.color_palette.begin();
     for(const auto& [name, ptr_bus] : routes) {
-        AddRoutePolyline(doc, ptr_bus->stops, *GetNextColor(iter_color), proj);
+        AddRoutePolyline(doc, catalogue, domain::RouteStops(*ptr_bus), *GetNextColor(iter_color), proj);
     }
 
 }
 
 // добавляет названия маршрутов
-void MapRenderer::AddRoutesNames(svg::Document& doc, const std::map<std::string_view,
-    const domain::Bus*>& buses, const SphereProjector& proj) const {
+void MapRenderer::AddRoutesNames(svg::Document& doc, const TransportCatalogue& catalogue,
+    const std::map<std::string_view, const domain::Bus*>& buses, const SphereProjector& proj) const {
 
     /*auto GetNextColor = [this]( auto& color_iter) {
         auto old_iter = color_iter;
@@ -77,15 +77,15 @@ void MapRenderer::AddRoutesNames(svg::Document& doc, const std::map<std::string_
             continue;
         } 
 
-        svg::Point pos = proj(ptr_bus->stops[0]->coord);
+        svg::Point pos = proj(catalogue.GetStopById(ptr_bus->stops[0])->coord);
         auto color_iter2 = GetNextColor(color_iter);
         AddTextLabel(doc, name, pos, *color_iter2, true);
 
         // совпадают ли крайние остановки некольцевого маршрута или нет
-        bool is_edge_stops_eq = *ptr_bus->stops.begin() == *(ptr_bus->stops.begin() + ptr_bus->stops.size() / 2);
+        bool is_edge_stops_eq = ptr_bus->stops.front() == ptr_bus->stops.back();
         
         if(ptr_bus->is_roundtrip == false && ptr_bus->stops.size() > 1 && !is_edge_stops_eq) {
-            pos = proj((*(ptr_bus->stops.begin() + ptr_bus->stops.size() / 2))->coord);
+            pos = proj(catalogue.GetStopById(ptr_bus->stops.back())->coord);
             AddTextLabel(doc, name, pos, *color_iter2, true);
         }
     }
@@ -149,7 +149,8 @@ void MapRenderer::AddStopsNames(svg::Document& doc, const std::vector<const doma
 }
 
 // Добавляет маршруты, остановки, названия в svg::Document
-svg::Document MapRenderer::Render(const std::unordered_set<const geo::Coordinates*>& coords, 
+svg::Document MapRenderer::Render(const TransportCatalogue& catalogue,
+                                  const std::unordered_set<const geo::CompactCoordinates*>& coords, 
                                   const std::map<std::string_view, const domain::Bus*>& buses, 
                                   const std::vector<const domain::Stop*>& stops) const {
     
@@ -157,9 +158,9 @@ svg::Document MapRenderer::Render(const std::unordered_set<const geo::Coordinate
 
     svg::Document doc;
     // добавляем ломаные линии маршрутов
-    AddRoutes(doc, buses, proj);
+    AddRoutes(doc, catalogue, buses, proj);
     // добавляем названия маршрутов
-    AddRoutesNames(doc, buses, proj);
+    AddRoutesNames(doc, catalogue, buses, proj);
     // добавляем круги, обозначающие остановки
     AddStopsCircles(doc, stops, proj);
     // добавляем названия остановок
@@ -168,7 +169,7 @@ svg::Document MapRenderer::Render(const std::unordered_set<const geo::Coordinate
     return doc;
 }
 
-SphereProjector MapRenderer::InitProjector(const std::unordered_set<const geo::Coordinates*>& coords) const {   
+SphereProjector MapRenderer::InitProjector(const std::unordered_set<const geo::CompactCoordinates*>& coords) const {   
     return SphereProjector{coords.begin(), coords.end(), 
         settings_.width, settings_.height, settings_.padding};
 }
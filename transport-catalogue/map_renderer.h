@@ -20,7 +20,8 @@ inline bool IsZero(double value) {
 
 class SphereProjector {
 public:
-    // points_begin и points_end задают начало и конец интервала элементов geo::Coordinates
+    // points_begin и points_end задают начало и конец интервала указателей на координаты
+    // (geo::Coordinates или geo::CompactCoordinates, последние раскодируются на лету)
     template <typename PointInputIt>
     SphereProjector(PointInputIt points_begin, PointInputIt points_end,
                     double max_width, double max_height, double padding)
@@ -34,16 +35,16 @@ public:
         // Находим точки с минимальной и максимальной долготой
         const auto [left_it, right_it] = std::minmax_element(
             points_begin, points_end,
-            [](auto lhs, auto rhs) { return lhs->lng < rhs->lng; });
-        min_lon_ = (*left_it)->lng;
-        const double max_lon = (*right_it)->lng;
+            [](auto lhs, auto rhs) { return geo::Coordinates(*lhs).lng < geo::Coordinates(*rhs).lng; });
+        min_lon_ = geo::Coordinates(**left_it).lng;
+        const double max_lon = geo::Coordinates(**right_it).lng;
 
         // Находим точки с минимальной и максимальной широтой
         const auto [bottom_it, top_it] = std::minmax_element(
             points_begin, points_end,
-            [](auto lhs, auto rhs) { return lhs->lat < rhs->lat; });
-        const double min_lat = (*bottom_it)->lat;
-        max_lat_ = (*top_it)->lat;
+            [](auto lhs, auto rhs) { return geo::Coordinates(*lhs).lat < geo::Coordinates(*rhs).lat; });
+        const double min_lat = geo::Coordinates(**bottom_it).lat;
+        max_lat_ = geo::Coordinates(**top_it).lat;
 
         // Вычисляем коэффициент масштабирования вдоль координаты x
         std::optional<double> width_zoom;
@@ -116,7 +117,8 @@ public:
     explicit MapRenderer(const detail::RenderSettings& settings);
 
     // Добавляет маршруты, остановки, названия в svg::Document
-    svg::Document Render(const std::unordered_set<const geo::Coordinates*>& coords, 
+    svg::Document Render(const catalogue::TransportCatalogue& catalogue,
+        const std::unordered_set<const geo::CompactCoordinates*>& coords, 
         const std::map<std::string_view, const domain::Bus*>& buses, 
         const std::vector<const domain::Stop*>& stops) const;
 
@@ -125,11 +127,13 @@ private:
     std::vector<svg::Color>::const_iterator GetNextColor(std::vector<svg::Color>::const_iterator& color_iter) const;
 
     // добавляет ломаные линии маршрутов
-    void AddRoutes(svg::Document& doc, const std::map<std::string_view, const domain::Bus*>& buses, 
+    void AddRoutes(svg::Document& doc, const catalogue::TransportCatalogue& catalogue,
+        const std::map<std::string_view, const domain::Bus*>& buses, 
         const SphereProjector& proj) const;
 
     // добавляет названия маршрутов
-    void AddRoutesNames(svg::Document& doc, const std::map<std::string_view, const domain::Bus*>& buses, 
+    void AddRoutesNames(svg::Document& doc, const catalogue::TransportCatalogue& catalogue,
+        const std::map<std::string_view, const domain::Bus*>& buses, 
         const SphereProjector& proj) const;
 
     // добавляет круги, обозначающие остановки   
@@ -140,10 +144,11 @@ private:
     void AddStopsNames(svg::Document& doc, const std::vector<const domain::Stop*>& stops, 
     const SphereProjector& proj) const;
 
-    SphereProjector InitProjector(const std::unordered_set<const geo::Coordinates*>& coords) const;
+    SphereProjector InitProjector(const std::unordered_set<const geo::CompactCoordinates*>& coords) const;
 
     // добавляет полилинию маршрута
-    void AddRoutePolyline(svg::Document& doc, const std::vector<const domain::Stop*>& stops, 
+    void AddRoutePolyline(svg::Document& doc, const catalogue::TransportCatalogue& catalogue,
+        domain::RouteStops stops, 
         const svg::Color& color, const SphereProjector& proj) const;
 
     // добавляет текст - название
@@ -0,0 +1,69 @@
+#include "mapped_file.h"
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SERIALIZATION_HAS_MMAP
+#endif
+
+using namespace std::literals;
+
+namespace serialization {
+
+#ifdef SERIALIZATION_HAS_MMAP
+MappedFile::MappedFile(const std::filesystem::path& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0) {
+        throw std::runtime_error("Cannot open file "s + path.string());
+    }
+    struct stat info;
+    if(::fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot stat file "s + path.string());
+    }
+    size_ = static_cast<size_t>(info.st_size);
+    if(size_ > 0) {
+        void* data = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+        if(data == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Cannot map file "s + path.string());
+        }
+        data_ = static_cast<const std::byte*>(data);
+    }
+    // отображение остаётся действительным после закрытия дескриптора
+    ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if(data_) {
+        ::munmap(const_cast<std::byte*>(data_), size_);
+    }
+}
+#else
+MappedFile::MappedFile(const std::filesystem::path& path) {
+    std::ifstream input(path, std::ios::binary | std::ios::ate);
+    if(!input) {
+        throw std::runtime_error("Cannot open file "s + path.string());
+    }
+    buffer_.resize(static_cast<size_t>(input.tellg()));
+    input.seekg(0);
+    if(!input.read(reinterpret_cast<char*>(buffer_.data()), buffer_.size())) {
+        throw std::runtime_error("Cannot read file "s + path.string());
+    }
+    size_ = buffer_.size();
+}
+
+MappedFile::~MappedFile() = default;
+#endif
+
+std::span<const std::byte> MappedFile::GetData() const {
+    return buffer_.empty() ? std::span<const std::byte>{data_, size_} : std::span<const std::byte>{buffer_};
+}
+
+}  // namespace serialization
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+namespace serialization {
+
+// Файл, отображённый в память только для чтения. Страницы берутся из кеша файловой системы,
+// поэтому несколько процессов, отобразивших один файл, делят одну физическую копию.
+// На платформах без mmap файл целиком читается в память
+class MappedFile {
+public:
+    // при ошибке открытия или отображения выбрасывает std::runtime_error
+    explicit MappedFile(const std::filesystem::path& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // содержимое файла; начало выровнено по границе страницы (или как у operator new)
+    std::span<const std::byte> GetData() const;
+
+private:
+    const std::byte* data_ = nullptr;
+    size_t size_ = 0;
+    // содержимое файла, если отображение недоступно
+    std::vector<std::byte> buffer_;
+};
+
+}  // namespace serialization
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace memory {
+
+// Приблизительный объём динамической памяти контейнеров в байтах, без самого объекта контейнера
+// и памяти, на которую ссылаются элементы. Для хеш-таблиц учитываются массив корзин и узлы
+// с указателем на следующий узел и сохранённым хешем
+
+template <typename T>
+size_t GetUsage(const std::vector<T>& items) {
+    return items.capacity() * sizeof(T);
+}
+
+template <typename T>
+size_t GetUsage(const std::vector<std::vector<T>>& rows) {
+    size_t usage = rows.capacity() * sizeof(std::vector<T>);
+    for(const auto& row : rows) {
+        usage += GetUsage(row);
+    }
+    return usage;
+}
+
+template <typename T>
+size_t GetUsage(const std::deque<T>& items) {
+    return items.size() * sizeof(T);
+}
+
+template <typename T>
+size_t GetUsage(const std::deque<std::vector<T>>& rows) {
+    size_t usage = rows.size() * sizeof(std::vector<T>);
+    for(const auto& row : rows) {
+        usage += GetUsage(row);
+    }
+    return usage;
+}
+
+template <typename Key, typename Value, typename... Rest>
+size_t GetUsage(const std::unordered_map<Key, Value, Rest...>& items) {
+    return items.bucket_count() * sizeof(void*)
+           + items.size() * (sizeof(std::pair<const Key, Value>) + sizeof(void*) + sizeof(size_t));
+}
+
+template <typename Key, typename... Rest>
+size_t GetUsage(const std::unordered_set<Key, Rest...>& items) {
+    return items.bucket_count() * sizeof(void*) + items.size() * (sizeof(Key) + sizeof(void*) + sizeof(size_t));
+}
+
+}  // namespace memory
@@ -0,0 +1,274 @@
+#include "name_index.h"
+
+#include <algorithm>
+#include <ranges>
+#include <stdexcept>
+
+namespace catalogue {
+
+namespace {
+
+// является ли байт продолжением многобайтового символа UTF-8
+bool IsContinuation(char byte) {
+    return (static_cast<unsigned char>(byte) & 0xC0) == 0x80;
+}
+
+// декодирует символ UTF-8, начинающийся с байта pos, и возвращает его длину в байтах;
+// байт некорректной последовательности считается отдельным символом
+size_t DecodeSymbol(std::string_view str, size_t pos, char32_t& code) {
+    const auto lead = static_cast<unsigned char>(str[pos]);
+    code = lead;
+    // длина последовательности и значащие биты первого байта
+    size_t length = 1;
+    char32_t bits = lead;
+    if((lead >> 5) == 0x6) {
+        length = 2;
+        bits = lead & 0x1F;
+    } else if((lead >> 4) == 0xE) {
+        length = 3;
+        bits = lead & 0x0F;
+    } else if((lead >> 3) == 0x1E) {
+        length = 4;
+        bits = lead & 0x07;
+    }
+    if(pos + length > str.size()) {
+        return 1;
+    }
+    for(size_t i = 1; i < length; ++i) {
+        if(!IsContinuation(str[pos + i])) {
+            return 1;
+        }
+        bits = (bits << 6) | (static_cast<unsigned char>(str[pos + i]) & 0x3F);
+    }
+    code = bits;
+    return length;
+}
+
+// раскладывает строку UTF-8 на символы
+void DecodeUtf8(std::string_view str, std::vector<char32_t>& result) {
+    result.clear();
+    for(size_t pos = 0; pos < str.size();) {
+        char32_t code;
+        pos += DecodeSymbol(str, pos, code);
+        result.push_back(code);
+    }
+}
+
+// длина строки в символах
+size_t CountSymbols(std::string_view str) {
+    size_t count = 0;
+    char32_t code;
+    for(size_t pos = 0; pos < str.size(); ++count) {
+        pos += DecodeSymbol(str, pos, code);
+    }
+    return count;
+}
+
+// длина общего префикса строк в символах
+uint32_t CommonPrefixLength(std::string_view lhs, std::string_view rhs) {
+    uint32_t length = 0;
+    char32_t code;
+    for(size_t pos = 0; pos < lhs.size() && pos < rhs.size(); ++length) {
+        const size_t size = DecodeSymbol(lhs, pos, code);
+        if(lhs.substr(pos, size) != rhs.substr(pos, size)) {
+            break;
+        }
+        pos += size;
+    }
+    return length;
+}
+}  // namespace
+
+NameIndex::NameIndex(std::vector<std::pair<std::string_view, domain::StopId>> names) {
+    std::sort(names.begin(), names.end());
+    std::vector<char> chars;
+    std::vector<uint32_t> offsets{0};
+    std::vector<domain::StopId> ids;
+    std::vector<uint32_t> lcp;
+    offsets.reserve(names.size() + 1);
+    ids.reserve(names.size());
+    lcp.reserve(names.size());
+    std::vector<char32_t> symbols;
+    std::string_view prev;
+    for(const auto& [name, id] : names) {
+        lcp.push_back(ids.empty() ? 0 : CommonPrefixLength(prev, name));
+        chars.insert(chars.end(), name.begin(), name.end());
+        offsets.push_back(static_cast<uint32_t>(chars.size()));
+        ids.push_back(id);
+        DecodeUtf8(name, symbols);
+        max_length_ = std::max(max_length_, symbols.size());
+        prev = name;
+    }
+
+    // стек позиций с неубывающими lcp, ещё не получивших ответ
+    std::vector<uint32_t> next_smaller(lcp.size(), static_cast<uint32_t>(lcp.size()));
+    std::vector<uint32_t> stack;
+    for(uint32_t i = 0; i < lcp.size(); ++i) {
+        while(!stack.empty() && lcp[stack.back()] > lcp[i]) {
+            next_smaller[stack.back()] = i;
+            stack.pop_back();
+        }
+        stack.push_back(i);
+    }
+
+    chars_ = FrozenArray<char>(std::move(chars));
+    offsets_ = FrozenArray<uint32_t>(std::move(offsets));
+    ids_ = FrozenArray<domain::StopId>(std::move(ids));
+    lcp_ = FrozenArray<uint32_t>(std::move(lcp));
+    next_smaller_ = FrozenArray<uint32_t>(std::move(next_smaller));
+}
+
+// использует готовое упакованное представление из чужой памяти
+NameIndex::NameIndex(const Data& data)
+    : chars_(data.chars)
+    , offsets_(data.offsets)
+    , ids_(data.ids)
+    , lcp_(data.lcp)
+    , next_smaller_(data.next_smaller)
+    , max_length_(data.max_length) {
+    const size_t size = data.ids.size();
+    if(data.offsets.size() != size + 1 || data.offsets.front() != 0 || data.offsets.back() != data.chars.size()
+       || !std::is_sorted(data.offsets.begin(), data.offsets.end()) || data.lcp.size() != size
+       || data.next_smaller.size() != size) {
+        throw std::runtime_error("Broken name index");
+    }
+    // поиск с опечатками полагается на длины префиксов и наибольшую длину названия, поэтому
+    // они пересчитываются: один проход по названиям без выделения памяти
+    size_t max_length = 0;
+    for(size_t i = 0; i < size; ++i) {
+        const std::string_view name = GetName(i);
+        const bool is_sorted = i == 0 || GetName(i - 1) <= name;
+        const uint32_t lcp = i == 0 ? 0 : CommonPrefixLength(GetName(i - 1), name);
+        if(!is_sorted || data.lcp[i] != lcp || data.next_smaller[i] <= i || data.next_smaller[i] > size) {
+            throw std::runtime_error("Broken name index");
+        }
+        max_length = std::max(max_length, CountSymbols(name));
+    }
+    if(max_length != max_length_) {
+        throw std::runtime_error("Broken name index");
+    }
+}
+
+NameIndex::Data NameIndex::GetData() const {
+    return {chars_.GetView(), offsets_.GetView(), ids_.GetView(), lcp_.GetView(), next_smaller_.GetView(),
+            max_length_};
+}
+
+std::string_view NameIndex::GetName(size_t pos) const {
+    return {chars_.data() + offsets_[pos], offsets_[pos + 1] - offsets_[pos]};
+}
+
+std::vector<domain::StopId> NameIndex::FindByPrefix(std::string_view prefix, size_t limit) const {
+    std::vector<domain::StopId> result;
+    size_t pos = *std::ranges::partition_point(std::views::iota(size_t{0}, ids_.size()), [this, prefix](size_t pos) {
+        return GetName(pos) < prefix;
+    });
+    for(; pos < ids_.size() && result.size() < limit && GetName(pos).starts_with(prefix); ++pos) {
+        result.push_back(ids_[pos]);
+    }
+    return result;
+}
+
+std::vector<domain::StopId> NameIndex::Find(std::string_view query, size_t max_distance, size_t limit) const {
+    // расстояние 0 - обычный поиск по префиксу; затем названия добавляются по возрастанию расстояния,
+    // пока не наберётся limit
+    std::vector<domain::StopId> result = FindByPrefix(query, limit);
+    if(max_distance == 0 || result.size() == limit) {
+        return result;
+    }
+    std::vector<char32_t> pattern;
+    DecodeUtf8(query, pattern);
+    for(size_t distance = 1; distance <= max_distance && result.size() < limit; ++distance) {
+        FindAtDistance(pattern, distance, limit, result);
+    }
+    return result;
+}
+
+// Названия обходятся по порядку как ветви префиксного дерева. Для каждой глубины depth хранится строка
+// таблицы Левенштейна между префиксом названия длины depth и префиксами запроса; строки общего
+// с предыдущим названием префикса не пересчитываются. Отрезок названий с общим префиксом пропускается,
+// если расстояние до любого из них заведомо больше distance либо уже меньше distance
+void NameIndex::FindAtDistance(const std::vector<char32_t>& pattern, size_t distance, size_t limit,
+                               std::vector<domain::StopId>& result) const {
+    const size_t width = pattern.size() + 1;
+    // rows[depth * width + j] - расстояние между префиксом названия длины depth и префиксом запроса длины j;
+    // best[depth] - наименьшее расстояние от запроса до префиксов названия длины не больше depth;
+    // rows_min[depth] - минимум строки depth, оценка снизу для более длинных префиксов;
+    // offsets[depth] - смещение в байтах символа depth текущего названия, общее для названий с этим префиксом
+    std::vector<size_t> rows((max_length_ + 1) * width);
+    std::vector<size_t> best(max_length_ + 1);
+    std::vector<size_t> rows_min(max_length_ + 1, 0);
+    std::vector<size_t> offsets(max_length_ + 1, 0);
+    for(size_t j = 0; j < width; ++j) {
+        rows[j] = j;
+    }
+    best[0] = pattern.size();
+
+    size_t depth = 0;
+    for(size_t i = 0; i < ids_.size() && result.size() < limit;) {
+        if(i > 0) {
+            depth = std::min<size_t>(depth, lcp_[i]);
+        }
+        const std::string_view name = GetName(i);
+
+        // skip - ни одно название отрезка не подходит, take - все названия отрезка на расстоянии distance
+        bool skip = false;
+        bool take = false;
+        while(true) {
+            if(best[depth] < distance || std::min(best[depth], rows_min[depth]) > distance) {
+                skip = true;
+                break;
+            }
+            if(best[depth] == distance && rows_min[depth] >= distance) {
+                take = true;
+                break;
+            }
+            if(offsets[depth] == name.size()) {
+                break;
+            }
+            char32_t symbol;
+            offsets[depth + 1] = offsets[depth] + DecodeSymbol(name, offsets[depth], symbol);
+            const size_t* prev = &rows[depth * width];
+            size_t* row = &rows[(depth + 1) * width];
+            row[0] = depth + 1;
+            size_t row_min = row[0];
+            for(size_t j = 1; j < width; ++j) {
+                const size_t cost = pattern[j - 1] == symbol ? 0 : 1;
+                row[j] = std::min({prev[j] + 1, row[j - 1] + 1, prev[j - 1] + cost});
+                row_min = std::min(row_min, row[j]);
+            }
+            ++depth;
+            best[depth] = std::min(best[depth - 1], row[width - 1]);
+            rows_min[depth] = row_min;
+        }
+
+        if(skip) {
+            // пропускаем все названия, начинающиеся с тех же depth символов
+            // (каждый переход по next_smaller_ уменьшает lcp_, поэтому переходов не больше depth)
+            ++i;
+            while(i < ids_.size() && lcp_[i] >= depth) {
+                i = next_smaller_[i];
+            }
+            continue;
+        }
+        if(take) {
+            // более длинные префиксы не ближе, берём названия отрезка подряд
+            result.push_back(ids_[i++]);
+            while(i < ids_.size() && lcp_[i] >= depth && result.size() < limit) {
+                result.push_back(ids_[i++]);
+            }
+            continue;
+        }
+        if(best[depth] == distance) {
+            result.push_back(ids_[i]);
+        }
+        ++i;
+    }
+}
+
+size_t NameIndex::GetMemoryUsage() const {
+    return chars_.GetMemoryUsage() + offsets_.GetMemoryUsage() + ids_.GetMemoryUsage() + lcp_.GetMemoryUsage()
+           + next_smaller_.GetMemoryUsage();
+}
+
+}  // namespace catalogue
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "domain.h"
+#include "frozen_array.h"
+
+namespace catalogue {
+
+// Индекс для поиска остановок по началу названия, в том числе с опечатками.
+// Названия лежат по порядку в собственном буфере индекса и задаются смещениями, для соседних
+// названий хранится длина общего префикса, поэтому названия с общим префиксом образуют
+// непрерывный отрезок, а массив обходится как префиксное дерево.
+// Расстояние редактирования считается по символам Unicode (названия в UTF-8).
+class NameIndex {
+public:
+    // упакованное представление: массивы без указателей, поэтому может лежать в файле снимка.
+    // Название i - [chars[offsets[i]], chars[offsets[i + 1]])
+    struct Data {
+        std::span<const char> chars;
+        std::span<const uint32_t> offsets;
+        std::span<const domain::StopId> ids;
+        std::span<const uint32_t> lcp;
+        std::span<const uint32_t> next_smaller;
+        uint64_t max_length;
+    };
+
+    NameIndex() = default;
+    // строит индекс по парам (название, id)
+    explicit NameIndex(std::vector<std::pair<std::string_view, domain::StopId>> names);
+    // использует готовое упакованное представление из чужой памяти, которая должна жить дольше индекса;
+    // проверяет согласованность массивов (в том числе длины общих префиксов) и при ошибке
+    // выбрасывает std::runtime_error
+    explicit NameIndex(const Data& data);
+
+    Data GetData() const;
+
+    // возвращает не более limit остановок, чьё название начинается со строки, отличающейся от query
+    // не более чем на max_distance вставок, удалений и замен символов;
+    // результат упорядочен по расстоянию, затем по названию
+    std::vector<domain::StopId> Find(std::string_view query, size_t max_distance, size_t limit) const;
+
+    // приблизительный объём занятой памяти в байтах
+    size_t GetMemoryUsage() const;
+
+private:
+    // название на позиции pos отсортированного массива
+    std::string_view GetName(size_t pos) const;
+
+    // точный поиск по префиксу
+    std::vector<domain::StopId> FindByPrefix(std::string_view prefix, size_t limit) const;
+    // добавляет в result по алфавиту названия, до которых от pattern ровно distance правок, пока в result
+    // меньше limit остановок
+    void FindAtDistance(const std::vector<char32_t>& pattern, size_t distance, size_t limit,
+                        std::vector<domain::StopId>& result) const;
+
+    FrozenArray<char> chars_;
+    FrozenArray<uint32_t> offsets_;
+    FrozenArray<domain::StopId> ids_;
+    // lcp_[i] - длина в символах общего префикса названий i - 1 и i
+    FrozenArray<uint32_t> lcp_;
+    // next_smaller_[i] - первая позиция после i с меньшим lcp_; все названия между ними
+    // начинаются с тех же lcp_[i] символов, что и название i - 1
+    FrozenArray<uint32_t> next_smaller_;
+    // наибольшая длина названия в символах
+    size_t max_length_ = 0;
+};
+
+}  // namespace catalogue
@@ -0,0 +1,25 @@
+#include "network_registry.h"
+
+#include <stdexcept>
+
+using namespace std::literals;
+
+namespace snapshot {
+
+SnapshotHolder& NetworkRegistry::AddNetwork(std::string name) {
+    auto [iter, inserted] = networks_.try_emplace(std::move(name));
+    if(!inserted) {
+        throw std::logic_error("Network \""s + iter->first + "\" already exists"s);
+    }
+    return iter->second;
+}
+
+std::shared_ptr<const DataSnapshot> NetworkRegistry::Get(std::string_view name) const {
+    auto iter = networks_.find(name);
+    if(iter == networks_.end()) {
+        return nullptr;
+    }
+    return iter->second.Get();
+}
+
+}  // namespace snapshot
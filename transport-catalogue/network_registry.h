@@ -0,0 +1,28 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "data_snapshot.h"
+
+namespace snapshot {
+
+// Несколько независимых транспортных сетей в одном процессе: у каждой своя публикуемая версия данных
+// (справочник, отрисовщик, маршрутизатор). Набор сетей задаётся до начала обработки запросов,
+// после этого реестр можно читать из разных потоков
+class NetworkRegistry {
+public:
+    // добавляет сеть и возвращает её хранилище версий; для существующего названия выбрасывает std::logic_error
+    SnapshotHolder& AddNetwork(std::string name);
+
+    // текущая версия данных сети или nullptr, если сеть неизвестна или данные ещё не опубликованы
+    std::shared_ptr<const DataSnapshot> Get(std::string_view name) const;
+
+private:
+    // узлы std::map не перемещаются, поэтому ссылки на хранилища версий стабильны
+    std::map<std::string, SnapshotHolder, std::less<>> networks_;
+};
+
+}  // namespace snapshot
@@ -0,0 +1,182 @@
+#include "perfect_hash.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace catalogue {
+
+namespace {
+
+// среднее число ключей в корзине
+constexpr size_t KEYS_PER_BUCKET = 4;
+// доля занятых ячеек таблицы размещения
+constexpr double LOAD_FACTOR = 0.85;
+// ограничения перебора смещений и зёрен хеширования
+constexpr uint32_t MAX_DISPLACEMENT = 1 << 20;
+constexpr int MAX_ATTEMPTS = 32;
+
+uint64_t Mix(uint64_t value) {
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ULL;
+    value ^= value >> 33;
+    return value;
+}
+
+// хеш строки, обрабатывает по 8 байт за шаг
+uint64_t Hash(std::string_view str, uint64_t seed) {
+    uint64_t hash = seed ^ (str.size() * 0x9e3779b97f4a7c15ULL);
+    size_t pos = 0;
+    for(; pos + sizeof(uint64_t) <= str.size(); pos += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, str.data() + pos, sizeof(word));
+        hash = std::rotl(hash ^ (word * 0x87c37b91114253d5ULL), 31) * 0x4cf5ad432745937fULL;
+    }
+    uint64_t tail = 0;
+    std::memcpy(&tail, str.data() + pos, str.size() - pos);
+    return Mix(hash ^ tail);
+}
+
+// равномерно отображает 32-битное значение в [0, range) без деления
+size_t Reduce(uint32_t value, size_t range) {
+    return static_cast<size_t>((static_cast<uint64_t>(value) * range) >> 32);
+}
+
+}  // namespace
+
+// строит функцию для набора уникальных ключей
+PerfectHashFunction::PerfectHashFunction(const std::vector<std::string_view>& keys)
+    : size_{keys.size()}
+    , table_size_{std::max(size_, static_cast<size_t>(static_cast<double>(size_) / LOAD_FACTOR))} {
+    if(keys.empty()) {
+        return;
+    }
+    std::vector<uint64_t> pilots;
+    std::vector<uint32_t> remap;
+    for(int attempt = 0; attempt < MAX_ATTEMPTS; ++attempt) {
+        seed_ = Mix(attempt + 1);
+        if(TryBuild(keys, pilots, remap)) {
+            pilots_ = FrozenArray<uint64_t>(std::move(pilots));
+            remap_ = FrozenArray<uint32_t>(std::move(remap));
+            return;
+        }
+    }
+    throw std::runtime_error("Failed to build perfect hash function");
+}
+
+// использует готовое упакованное представление из чужой памяти
+PerfectHashFunction::PerfectHashFunction(const Data& data)
+    : seed_{data.seed}
+    , size_{static_cast<size_t>(data.size)}
+    , table_size_{static_cast<size_t>(data.table_size)}
+    , pilots_(data.pilots)
+    , remap_(data.remap) {
+    // ячейка ключа должна попадать в [0, size): все значения, по которым её ищет operator(), проверяются
+    if(data.table_size < data.size || data.table_size > std::numeric_limits<uint32_t>::max()
+       || (data.size > 0 && data.pilots.empty()) || data.remap.size() != data.table_size - data.size
+       || std::any_of(data.remap.begin(), data.remap.end(), [&data](uint32_t slot) { return slot >= data.size; })) {
+        throw std::runtime_error("Broken perfect hash function");
+    }
+}
+
+PerfectHashFunction::Data PerfectHashFunction::GetData() const {
+    return {seed_, size_, table_size_, pilots_.GetView(), remap_.GetView()};
+}
+
+// возвращает ячейку ключа
+size_t PerfectHashFunction::operator()(std::string_view key) const {
+    uint64_t hash = Hash(key, seed_);
+    const size_t slot = GetSlot(hash, pilots_[GetBucket(hash, pilots_.size())]);
+    return slot < size_ ? slot : remap_[slot - size_];
+}
+
+size_t PerfectHashFunction::GetSize() const {
+    return size_;
+}
+
+size_t PerfectHashFunction::GetMemoryUsage() const {
+    return pilots_.GetMemoryUsage() + remap_.GetMemoryUsage();
+}
+
+// пытается разместить все ключи с заданным зерном хеширования
+bool PerfectHashFunction::TryBuild(const std::vector<std::string_view>& keys, std::vector<uint64_t>& pilots,
+                                   std::vector<uint32_t>& remap) const {
+    const size_t buckets_count = (keys.size() + KEYS_PER_BUCKET - 1) / KEYS_PER_BUCKET;
+    pilots.assign(buckets_count, 0);
+
+    std::vector<std::vector<uint64_t>> buckets(buckets_count);
+    for(std::string_view key : keys) {
+        uint64_t hash = Hash(key, seed_);
+        buckets[GetBucket(hash, buckets_count)].push_back(hash);
+    }
+    // самые заполненные корзины размещаем первыми, пока свободных ячеек больше всего
+    std::vector<size_t> order(buckets_count);
+    for(size_t i = 0; i < buckets_count; ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&buckets](size_t lhs, size_t rhs) {
+        return buckets[lhs].size() > buckets[rhs].size();
+    });
+
+    std::vector<bool> taken(table_size_);
+    std::vector<size_t> slots;
+    for(size_t bucket : order) {
+        const auto& hashes = buckets[bucket];
+        if(hashes.empty()) {
+            break;
+        }
+        bool placed = false;
+        for(uint32_t displacement = 0; displacement < MAX_DISPLACEMENT && !placed; ++displacement) {
+            const uint64_t pilot = Mix(displacement);
+            slots.clear();
+            placed = true;
+            for(uint64_t hash : hashes) {
+                size_t slot = GetSlot(hash, pilot);
+                if(taken[slot] || std::find(slots.begin(), slots.end(), slot) != slots.end()) {
+                    placed = false;
+                    break;
+                }
+                slots.push_back(slot);
+            }
+            if(placed) {
+                pilots[bucket] = pilot;
+                for(size_t slot : slots) {
+                    taken[slot] = true;
+                }
+            }
+        }
+        if(!placed) {
+            return false;
+        }
+    }
+
+    // занятые ячейки хвоста таблицы получают по порядку свободные ячейки из [0, size_)
+    remap.assign(table_size_ - size_, 0);
+    size_t free_slot = 0;
+    for(size_t slot = size_; slot < table_size_; ++slot) {
+        if(!taken[slot]) {
+            continue;
+        }
+        while(taken[free_slot]) {
+            ++free_slot;
+        }
+        remap[slot - size_] = static_cast<uint32_t>(free_slot++);
+    }
+    return true;
+}
+
+// корзина и позиция ключа с хешем hash при перемешанном смещении pilot
+size_t PerfectHashFunction::GetBucket(uint64_t hash, size_t buckets_count) {
+    return Reduce(static_cast<uint32_t>(hash >> 32), buckets_count);
+}
+
+size_t PerfectHashFunction::GetSlot(uint64_t hash, uint64_t pilot) const {
+    // умножение переносит различия младших битов в старшие, по которым выбирается позиция
+    return Reduce(static_cast<uint32_t>(((hash ^ pilot) * 0x9e3779b97f4a7c15ULL) >> 32), table_size_);
+}
+
+}  // namespace catalogue
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "frozen_array.h"
+
+namespace catalogue {
+
+// Минимальная совершенная хеш-функция (схема CHD - "hash, displace"): переводит каждый
+// из заранее известных ключей в свою ячейку [0, size) без коллизий.
+// Ключи распределяются по корзинам, для каждой корзины подбирается смещение,
+// при котором её ключи попадают в свободные ячейки. Таблица размещения берётся с запасом (LOAD_FACTOR < 1),
+// чтобы последние корзины находили место за несколько попыток; ячейки за пределами [0, size)
+// переназначаются на оставшиеся свободные. Для ключа вне набора возвращается произвольная ячейка.
+class PerfectHashFunction {
+public:
+    // упакованное представление: параметры и массивы без указателей, поэтому может лежать в файле снимка
+    struct Data {
+        uint64_t seed;
+        uint64_t size;
+        uint64_t table_size;
+        std::span<const uint64_t> pilots;
+        std::span<const uint32_t> remap;
+    };
+
+    PerfectHashFunction() = default;
+    // строит функцию для набора уникальных ключей;
+    // если подобрать смещения не удалось, выбрасывает std::runtime_error
+    explicit PerfectHashFunction(const std::vector<std::string_view>& keys);
+    // использует готовое упакованное представление из чужой памяти, которая должна жить дольше функции;
+    // при несогласованных данных выбрасывает std::runtime_error
+    explicit PerfectHashFunction(const Data& data);
+
+    Data GetData() const;
+
+    // возвращает ячейку ключа
+    size_t operator()(std::string_view key) const;
+
+    size_t GetSize() const;
+
+    // приблизительный объём занятой памяти в байтах
+    size_t GetMemoryUsage() const;
+
+private:
+    // пытается разместить все ключи с заданным зерном хеширования
+    bool TryBuild(const std::vector<std::string_view>& keys, std::vector<uint64_t>& pilots,
+                  std::vector<uint32_t>& remap) const;
+    // корзина и позиция ключа с хешем hash при перемешанном смещении pilot
+    static size_t GetBucket(uint64_t hash, size_t buckets_count);
+    size_t GetSlot(uint64_t hash, uint64_t pilot) const;
+
+    uint64_t seed_ = 0;
+    size_t size_ = 0;
+    // размер таблицы размещения, не меньше size_
+    size_t table_size_ = 0;
+    // перемешанные смещения корзин: хранятся готовыми, чтобы не пересчитывать при поиске
+    FrozenArray<uint64_t> pilots_;
+    // итоговые ячейки для позиций таблицы [size_, table_size_)
+    FrozenArray<uint32_t> remap_;
+};
+
+}  // namespace catalogue
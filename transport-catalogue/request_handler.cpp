@@ -5,7 +5,7 @@ svg::Document RequestHandler::RenderMap() const {
     auto routes = db_.GetAllRoutes();
     std::map<std::string_view, const domain::Bus*> ordered_routes{routes.begin(), routes.end()};
 
-    return renderer_.Render(GetStopsCoord(routes), ordered_routes, GetOrderedStops());
+    return renderer_.Render(db_, GetStopsCoord(routes), ordered_routes, GetOrderedStops());
 }
 
 const TransportCatalogue& RequestHandler::GetTransportCatalogue() const {
@@ -24,28 +24,36 @@ const std::vector<const domain::Stop*> RequestHandler::GetOrderedStops() const {
     std::set<const domain::Stop*, decltype(comp)> stops;
 
     for(const auto& [route_name, ptr_bus] : routes) {
-        for(const auto& stop : ptr_bus->stops) {
-            stops.insert(stop);
+        for(domain::StopId stop : ptr_bus->stops) {
+            stops.insert(db_.GetStopById(stop));
         }
     }
     return {stops.begin(), stops.end()};
 }
 
 // возвращает указатели на координаты всех уникальных остановок
-const std::unordered_set<const geo::Coordinates*> RequestHandler::GetStopsCoord(
+const std::unordered_set<const geo::CompactCoordinates*> RequestHandler::GetStopsCoord(
     const std::unordered_map<std::string_view, const domain::Bus*>& routes) const {
 
-    std::unordered_set<const geo::Coordinates*> res;
+    std::unordered_set<const geo::CompactCoordinates*> res;
 
     for(auto& [name, ptr_bus] : routes) {        
-        for(const auto& stop : ptr_bus->stops) {
-            res.insert(&stop->coord);
-        }     
+        for(domain::StopId stop : ptr_bus->stops) {
+            res.insert(&db_.GetStopById(stop)->coord);
+        }
     }
 
     return res;
 }
 
+size_t RequestHandler::GetCatalogueMemoryUsage() const {
+    return db_.GetMemoryUsage();
+}
+
+size_t RequestHandler::GetRouterMemoryUsage() const {
+    return router_.GetMemoryUsage();
+}
+
 // ищет подходящий маршрут
 std::optional<router::ResultRoute> RequestHandler::GetRoute(std::string_view from, std::string_view to) const {
     return router_.BuildRoute(db_.GetStop(from), db_.GetStop(to));
@@ -3,7 +3,10 @@
 #include "transport_catalogue.h"
 #include "map_renderer.h"
 #include "transport_router.h"
+#include "data_snapshot.h"
 
+#include <memory>
+#include <set>
 #include <vector>
 #include <unordered_set>
 
@@ -19,6 +22,14 @@ public:
                                                             router_{router} {
     }
 
+    // работает с версией данных snapshot и удерживает её до своего уничтожения
+    explicit RequestHandler(std::shared_ptr<const snapshot::DataSnapshot> snapshot) :
+                                                            snapshot_{std::move(snapshot)},
+                                                            db_{snapshot_->GetCatalogue()},
+                                                            renderer_{snapshot_->GetRenderer()},
+                                                            router_{snapshot_->GetRouter()} {
+    }
+
     // возвращает svg::Document с картой маршрутов
     svg::Document RenderMap() const;
 
@@ -27,15 +38,20 @@ public:
     // ищет подходящий маршрут
     std::optional<router::ResultRoute> GetRoute(std::string_view from, std::string_view to) const;
 
+    // приблизительный объём памяти справочника и маршрутизатора в байтах
+    size_t GetCatalogueMemoryUsage() const;
+    size_t GetRouterMemoryUsage() const;
+
 private:
     // возвращает указатели на координаты всех уникальных остановок
-    const std::unordered_set<const geo::Coordinates*> GetStopsCoord(
+    const std::unordered_set<const geo::CompactCoordinates*> GetStopsCoord(
         const std::unordered_map<std::string_view, const domain::Bus*>& routes) const;
 
     // возвращает вектор указателей на остановки, отсортированный по алфавиту
     // остановки, через которые не проходят автобусы в векторе отсутствуют
     const std::vector<const domain::Stop*> GetOrderedStops() const;
 
+    std::shared_ptr<const snapshot::DataSnapshot> snapshot_;
     const catalogue::TransportCatalogue& db_;
     const renderer::MapRenderer& renderer_;
     const router::TransportRouter& router_;
@@ -0,0 +1,114 @@
+#include "road_distances.h"
+#include "memory_usage.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace catalogue {
+
+// задаёт расстояние from -> to, для to -> from оно используется, пока не задано явно
+void RoadDistances::Add(domain::StopId from, domain::StopId to, size_t distance) {
+    if(is_compact_) {
+        throw std::logic_error("Road distances are compacted");
+    }
+    if(distance > std::numeric_limits<uint32_t>::max()) {
+        throw std::out_of_range("Road distance is too large");
+    }
+    Set(from, to, static_cast<uint32_t>(distance), true);
+    Set(to, from, static_cast<uint32_t>(distance), false);
+}
+
+// возвращает расстояние from -> to или std::nullopt, если оно не задано ни в одну сторону
+std::optional<size_t> RoadDistances::Find(domain::StopId from, domain::StopId to) const {
+    const Entry* begin = nullptr;
+    const Entry* end = nullptr;
+    if(is_compact_) {
+        if(from + 1 >= offsets_.size()) {
+            return std::nullopt;
+        }
+        begin = entries_.data() + offsets_[from];
+        end = entries_.data() + offsets_[from + 1];
+    } else {
+        if(from >= rows_.size()) {
+            return std::nullopt;
+        }
+        begin = rows_[from].data();
+        end = begin + rows_[from].size();
+    }
+    const Entry* entry = LowerBound(begin, end, to);
+    if(entry == end || entry->to != to) {
+        return std::nullopt;
+    }
+    return entry->distance;
+}
+
+// упаковывает строки в единый массив со смещениями и освобождает их
+void RoadDistances::Compact() {
+    if(is_compact_) {
+        return;
+    }
+    size_t total = 0;
+    for(const Row& row : rows_) {
+        total += row.size();
+    }
+    std::vector<Entry> entries;
+    std::vector<uint32_t> offsets;
+    entries.reserve(total);
+    offsets.reserve(rows_.size() + 1);
+    offsets.push_back(0);
+    for(const Row& row : rows_) {
+        entries.insert(entries.end(), row.begin(), row.end());
+        offsets.push_back(static_cast<uint32_t>(entries.size()));
+    }
+    offsets_ = FrozenArray<uint32_t>(std::move(offsets));
+    entries_ = FrozenArray<Entry>(std::move(entries));
+    std::vector<Row>{}.swap(rows_);
+    is_compact_ = true;
+}
+
+// использует готовое упакованное представление из чужой памяти
+void RoadDistances::Attach(std::span<const uint32_t> offsets, std::span<const Entry> entries) {
+    if(is_compact_ || !rows_.empty()) {
+        throw std::logic_error("Road distances are not empty");
+    }
+    offsets_ = FrozenArray<uint32_t>(offsets);
+    entries_ = FrozenArray<Entry>(entries);
+    is_compact_ = true;
+}
+
+std::span<const uint32_t> RoadDistances::GetOffsets() const {
+    return offsets_.GetView();
+}
+
+std::span<const RoadDistances::Entry> RoadDistances::GetEntries() const {
+    return entries_.GetView();
+}
+
+// возвращает указатель на позицию соседа to в строке [begin, end) (или на место для его вставки)
+const RoadDistances::Entry* RoadDistances::LowerBound(const Entry* begin, const Entry* end, domain::StopId to) {
+    return std::lower_bound(begin, end, to, [](const Entry& entry, domain::StopId id) {
+        return entry.to < id;
+    });
+}
+
+// вставляет или обновляет запись в строке from
+void RoadDistances::Set(domain::StopId from, domain::StopId to, uint32_t distance, bool is_explicit) {
+    if(from >= rows_.size()) {
+        rows_.resize(from + 1);
+    }
+    Row& row = rows_[from];
+    auto pos = row.begin() + (LowerBound(row.data(), row.data() + row.size(), to) - row.data());
+    if(pos == row.end() || pos->to != to) {
+        row.insert(pos, Entry{to, distance, is_explicit});
+    } else if(is_explicit || !pos->is_explicit) {
+        // явно заданное расстояние не перезаписывается обратным
+        *pos = Entry{to, distance, is_explicit || pos->is_explicit};
+    }
+}
+
+size_t RoadDistances::GetMemoryUsage() const {
+    return memory::GetUsage(rows_) + offsets_.GetMemoryUsage() + entries_.GetMemoryUsage();
+}
+
+}  // namespace catalogue
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "domain.h"
+#include "frozen_array.h"
+
+namespace catalogue {
+
+// Хранит фактические расстояния между остановками в виде списков смежности:
+// для каждой остановки - отсортированный по id соседа массив пар (сосед, расстояние).
+// Обратное направление заполняется при добавлении, поэтому поиск - один бинарный поиск в строке.
+// После Compact() строки склеиваются в единый массив (CSR) и добавление запрещено.
+class RoadDistances {
+public:
+    // запись упакованного представления; не содержит указателей, поэтому может лежать в файле снимка.
+    // Выравнивание задано явным полем, чтобы в файл не попадали неинициализированные байты
+    struct Entry {
+        domain::StopId to;
+        uint32_t distance;
+        bool is_explicit;  // задано ли расстояние именно в этом направлении
+        uint8_t padding[3] = {};
+    };
+    static_assert(sizeof(Entry) == 12 && std::has_unique_object_representations_v<Entry>);
+
+    // задаёт расстояние from -> to, для to -> from оно используется, пока не задано явно;
+    // расстояние должно помещаться в uint32_t, иначе выбрасывается std::out_of_range
+    void Add(domain::StopId from, domain::StopId to, size_t distance);
+
+    // возвращает расстояние from -> to или std::nullopt, если оно не задано ни в одну сторону
+    std::optional<size_t> Find(domain::StopId from, domain::StopId to) const;
+
+    // упаковывает строки в единый массив со смещениями и освобождает их
+    void Compact();
+
+    // использует готовое упакованное представление из чужой памяти, которая должна жить дольше объекта;
+    // смещения и записи должны быть согласованы (offsets.back() == entries.size())
+    void Attach(std::span<const uint32_t> offsets, std::span<const Entry> entries);
+
+    // упакованное представление, доступно после Compact() или Attach()
+    std::span<const uint32_t> GetOffsets() const;
+    std::span<const Entry> GetEntries() const;
+
+    // приблизительный объём собственной памяти в байтах
+    size_t GetMemoryUsage() const;
+
+private:
+    using Row = std::vector<Entry>;
+
+    // возвращает указатель на позицию соседа to в строке [begin, end) (или на место для его вставки)
+    static const Entry* LowerBound(const Entry* begin, const Entry* end, domain::StopId to);
+    // вставляет или обновляет запись в строке from
+    void Set(domain::StopId from, domain::StopId to, uint32_t distance, bool is_explicit);
+
+    // строки смежности, индекс - id остановки
+    std::vector<Row> rows_;
+
+    // упакованное представление: строка остановки id - [entries_[offsets_[id]], entries_[offsets_[id + 1]])
+    FrozenArray<uint32_t> offsets_;
+    FrozenArray<Entry> entries_;
+    bool is_compact_ = false;
+};
+
+}  // namespace catalogue
@@ -6,9 +6,10 @@
 #include <cassert>
 #include <cstdint>
 #include <iterator>
+#include <limits>
 #include <optional>
+#include <span>
 #include <stdexcept>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -20,7 +21,20 @@ private:
     using Graph = DirectedWeightedGraph<Weight>;
 
 public:
+    // кратчайший путь между парой вершин: вес и последнее ребро пути.
+    // Не содержит указателей, поэтому таблица может лежать в файле снимка
+    struct RouteInternalData {
+        Weight weight;
+        EdgeId prev_edge;
+    };
+    // prev_edge пути без рёбер (из вершины в неё саму) и prev_edge недостижимой вершины
+    static constexpr EdgeId NO_EDGE = std::numeric_limits<EdgeId>::max();
+    static constexpr EdgeId NO_ROUTE = NO_EDGE - 1;
+
     explicit Router(const Graph& graph);
+    // использует готовую таблицу путей из чужой памяти, которая должна жить дольше маршрутизатора;
+    // при несовпадении размера таблицы с графом выбрасывает std::runtime_error
+    Router(const Graph& graph, std::span<const RouteInternalData> routes);
 
     struct RouteInfo {
         Weight weight;
@@ -28,47 +42,51 @@ public:
     };
 
     std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const;
+    // таблица путей: путь из from в to - routes[from * vertex_count + to]
+    std::span<const RouteInternalData> GetRoutes() const;
+    // приблизительный объём занятой памяти в байтах (без графа)
+    size_t GetMemoryUsage() const;
 
 private:
-    struct RouteInternalData {
-        Weight weight;
-        std::optional<EdgeId> prev_edge;
-    };
-    using RoutesInternalData = std::vector<std::vector<std::optional<RouteInternalData>>>;
+    static bool HasRoute(const RouteInternalData& route) {
+        return route.prev_edge != NO_ROUTE;
+    }
 
-    void InitializeRoutesInternalData(const Graph& graph) {
+    void InitializeRoutesInternalData(const Graph& graph, std::vector<RouteInternalData>& routes) {
         const size_t vertex_count = graph.GetVertexCount();
         for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
-            routes_internal_data_[vertex][vertex] = RouteInternalData{ZERO_WEIGHT, std::nullopt};
+            routes[vertex * vertex_count + vertex] = RouteInternalData{ZERO_WEIGHT, NO_EDGE};
             for (const EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
                 const auto& edge = graph.GetEdge(edge_id);
                 if (edge.weight < ZERO_WEIGHT) {
                     throw std::domain_error("Edges' weights should be non-negative");
                 }
-                auto& route_internal_data = routes_internal_data_[vertex][edge.to];
-                if (!route_internal_data || route_internal_data->weight > edge.weight) {
+                auto& route_internal_data = routes[vertex * vertex_count + edge.to];
+                if (!HasRoute(route_internal_data) || route_internal_data.weight > edge.weight) {
                     route_internal_data = RouteInternalData{edge.weight, edge_id};
                 }
             }
         }
     }
 
-    void RelaxRoute(VertexId vertex_from, VertexId vertex_to, const RouteInternalData& route_from,
-                    const RouteInternalData& route_to) {
-        auto& route_relaxing = routes_internal_data_[vertex_from][vertex_to];
+    static void RelaxRoute(RouteInternalData& route_relaxing, const RouteInternalData& route_from,
+                           const RouteInternalData& route_to) {
         const Weight candidate_weight = route_from.weight + route_to.weight;
-        if (!route_relaxing || candidate_weight < route_relaxing->weight) {
+        if (!HasRoute(route_relaxing) || candidate_weight < route_relaxing.weight) {
             route_relaxing = {candidate_weight,
-                              route_to.prev_edge ? route_to.prev_edge : route_from.prev_edge};
+                              route_to.prev_edge != NO_EDGE ? route_to.prev_edge : route_from.prev_edge};
         }
     }
 
-    void RelaxRoutesInternalDataThroughVertex(size_t vertex_count, VertexId vertex_through) {
+    static void RelaxRoutesInternalDataThroughVertex(size_t vertex_count, VertexId vertex_through,
+                                                     std::vector<RouteInternalData>& routes) {
+        const RouteInternalData* routes_through = routes.data() + vertex_through * vertex_count;
         for (VertexId vertex_from = 0; vertex_from < vertex_count; ++vertex_from) {
-            if (const auto& route_from = routes_internal_data_[vertex_from][vertex_through]) {
+            RouteInternalData* routes_from = routes.data() + vertex_from * vertex_count;
+            if (const auto& route_from = routes_from[vertex_through]; HasRoute(route_from)) {
                 for (VertexId vertex_to = 0; vertex_to < vertex_count; ++vertex_to) {
-                    if (const auto& route_to = routes_internal_data_[vertex_through][vertex_to]) {
-                        RelaxRoute(vertex_from, vertex_to, *route_from, *route_to);
+                    if (const auto& route_to = routes_through[vertex_to]; HasRoute(route_to)) {
+                        RelaxRoute(routes_from[vertex_to], route_from, route_to);
                     }
                 }
             }
@@ -77,41 +95,71 @@ private:
 
     static constexpr Weight ZERO_WEIGHT{};
     const Graph& graph_;
-    RoutesInternalData routes_internal_data_;
+    // таблица vertex_count x vertex_count по строкам
+    catalogue::FrozenArray<RouteInternalData> routes_internal_data_;
 };
 
 template <typename Weight>
 Router<Weight>::Router(const Graph& graph)
     : graph_(graph)
-    , routes_internal_data_(graph.GetVertexCount(),
-                            std::vector<std::optional<RouteInternalData>>(graph.GetVertexCount()))
 {
-    InitializeRoutesInternalData(graph);
-
     const size_t vertex_count = graph.GetVertexCount();
+    std::vector<RouteInternalData> routes(vertex_count * vertex_count, RouteInternalData{ZERO_WEIGHT, NO_ROUTE});
+    InitializeRoutesInternalData(graph, routes);
+
     for (VertexId vertex_through = 0; vertex_through < vertex_count; ++vertex_through) {
-        RelaxRoutesInternalDataThroughVertex(vertex_count, vertex_through);
+        RelaxRoutesInternalDataThroughVertex(vertex_count, vertex_through, routes);
+    }
+    routes_internal_data_ = catalogue::FrozenArray<RouteInternalData>(std::move(routes));
+}
+
+template <typename Weight>
+Router<Weight>::Router(const Graph& graph, std::span<const RouteInternalData> routes)
+    : graph_(graph)
+    , routes_internal_data_(routes)
+{
+    const size_t vertex_count = graph.GetVertexCount();
+    if (routes.size() != vertex_count * vertex_count) {
+        throw std::runtime_error("Route table does not match the graph");
     }
 }
 
 template <typename Weight>
 std::optional<typename Router<Weight>::RouteInfo> Router<Weight>::BuildRoute(VertexId from,
                                                                              VertexId to) const {
-    const auto& route_internal_data = routes_internal_data_.at(from).at(to);
-    if (!route_internal_data) {
+    const size_t vertex_count = graph_.GetVertexCount();
+    if (from >= vertex_count || to >= vertex_count) {
+        throw std::out_of_range("Unknown vertex");
+    }
+    const auto& route_internal_data = routes_internal_data_[from * vertex_count + to];
+    if (!HasRoute(route_internal_data)) {
         return std::nullopt;
     }
-    const Weight weight = route_internal_data->weight;
+    const Weight weight = route_internal_data.weight;
     std::vector<EdgeId> edges;
-    for (std::optional<EdgeId> edge_id = route_internal_data->prev_edge;
-         edge_id;
-         edge_id = routes_internal_data_[from][graph_.GetEdge(*edge_id).from]->prev_edge)
+    for (EdgeId edge_id = route_internal_data.prev_edge;
+         edge_id != NO_EDGE;
+         edge_id = routes_internal_data_[from * vertex_count + graph_.GetEdge(edge_id).from].prev_edge)
     {
-        edges.push_back(*edge_id);
+        edges.push_back(edge_id);
+        // кратчайший путь не длиннее числа вершин; иначе таблица испорчена и путь зациклен
+        if (edges.size() > vertex_count) {
+            throw std::runtime_error("Broken route table");
+        }
     }
     std::reverse(edges.begin(), edges.end());
 
     return RouteInfo{weight, std::move(edges)};
 }
 
+template <typename Weight>
+std::span<const typename Router<Weight>::RouteInternalData> Router<Weight>::GetRoutes() const {
+    return routes_internal_data_.GetView();
+}
+
+template <typename Weight>
+size_t Router<Weight>::GetMemoryUsage() const {
+    return routes_internal_data_.GetMemoryUsage();
+}
+
 }  // namespace graph
\ No newline at end of file
@@ -0,0 +1,429 @@
+#include "serialization.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "mapped_file.h"
+
+using namespace std::literals;
+
+namespace serialization {
+
+namespace {
+
+const char MAGIC[8] = {'T', 'C', 'S', 'N', 'A', 'P', '\0', '\0'};
+// увеличивается при любом изменении формата
+const uint32_t VERSION = 4;
+// выравнивание начала массивов, достаточное для всех типов элементов
+const size_t ALIGNMENT = 8;
+
+// порядок альтернатив svg::Color
+enum class ColorType : uint8_t {
+    NONE,
+    STRING,
+    RGB,
+    RGBA
+};
+
+// последовательная запись снимка; массивы выравниваются, чтобы их можно было использовать
+// прямо из отображённого в память файла
+class Writer {
+public:
+    explicit Writer(std::ostream& output)
+        : output_(output) {
+    }
+
+    template <typename T>
+    void Write(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        WriteBytes(&value, sizeof(T));
+    }
+
+    // число элементов (uint64), выравнивание и сами элементы
+    template <typename T>
+    void WriteArray(std::span<const T> values) {
+        static_assert(std::is_trivially_copyable_v<T> && alignof(T) <= ALIGNMENT);
+        Write(static_cast<uint64_t>(values.size()));
+        Align();
+        WriteBytes(values.data(), values.size_bytes());
+    }
+
+    void WriteString(std::string_view str) {
+        Write(static_cast<uint32_t>(str.size()));
+        WriteBytes(str.data(), str.size());
+    }
+
+    void WriteBytes(const void* data, size_t size) {
+        output_.write(static_cast<const char*>(data), size);
+        position_ += size;
+    }
+
+private:
+    void Align() {
+        const char zeros[ALIGNMENT] = {};
+        WriteBytes(zeros, (ALIGNMENT - position_ % ALIGNMENT) % ALIGNMENT);
+    }
+
+    std::ostream& output_;
+    size_t position_ = 0;
+};
+
+// последовательное чтение снимка из памяти; массивы возвращаются как span на эту память
+class Reader {
+public:
+    explicit Reader(std::span<const std::byte> data)
+        : data_(data) {
+    }
+
+    template <typename T>
+    T Read() {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value;
+        std::memcpy(&value, Take(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    template <typename T>
+    std::span<const T> ReadArray() {
+        static_assert(std::is_trivially_copyable_v<T> && alignof(T) <= ALIGNMENT);
+        const auto count = Read<uint64_t>();
+        Take((ALIGNMENT - position_ % ALIGNMENT) % ALIGNMENT);
+        if(count > (data_.size() - position_) / sizeof(T)) {
+            throw std::runtime_error("Unexpected end of catalogue snapshot");
+        }
+        const std::byte* begin = Take(count * sizeof(T));
+        if(reinterpret_cast<uintptr_t>(begin) % alignof(T) != 0) {
+            throw std::runtime_error("Misaligned catalogue snapshot");
+        }
+        return {reinterpret_cast<const T*>(begin), static_cast<size_t>(count)};
+    }
+
+    std::string ReadString() {
+        const auto size = Read<uint32_t>();
+        const std::byte* begin = Take(size);
+        return {reinterpret_cast<const char*>(begin), size};
+    }
+
+    const std::byte* Take(size_t size) {
+        if(size > data_.size() - position_) {
+            throw std::runtime_error("Unexpected end of catalogue snapshot");
+        }
+        const std::byte* begin = data_.data() + position_;
+        position_ += size;
+        return begin;
+    }
+
+private:
+    std::span<const std::byte> data_;
+    size_t position_ = 0;
+};
+
+// проверяет, что offsets - неубывающие смещения строк массива размера size, начинающиеся с 0
+void CheckOffsets(std::span<const uint32_t> offsets, size_t rows, size_t size) {
+    if(offsets.size() != rows + 1 || offsets.front() != 0 || offsets.back() != size
+       || !std::is_sorted(offsets.begin(), offsets.end())) {
+        throw std::runtime_error("Broken offsets in catalogue snapshot");
+    }
+}
+
+// проверяет, что все идентификаторы меньше count
+void CheckIds(std::span<const uint32_t> ids, size_t count) {
+    if(std::any_of(ids.begin(), ids.end(), [count](uint32_t id) { return id >= count; })) {
+        throw std::runtime_error("Unknown id in catalogue snapshot");
+    }
+}
+
+void WriteColor(Writer& output, const svg::Color& color) {
+    if(const auto* str = std::get_if<std::string>(&color)) {
+        output.Write(ColorType::STRING);
+        output.WriteString(*str);
+    } else if(const auto* rgba = std::get_if<svg::Rgba>(&color)) {
+        output.Write(ColorType::RGBA);
+        output.Write(rgba->red);
+        output.Write(rgba->green);
+        output.Write(rgba->blue);
+        output.Write(rgba->opacity);
+    } else if(const auto* rgb = std::get_if<svg::Rgb>(&color)) {
+        output.Write(ColorType::RGB);
+        output.Write(rgb->red);
+        output.Write(rgb->green);
+        output.Write(rgb->blue);
+    } else {
+        output.Write(ColorType::NONE);
+    }
+}
+
+svg::Color ReadColor(Reader& input) {
+    switch(input.Read<ColorType>()) {
+        case ColorType::NONE:
+            return {};
+        case ColorType::STRING:
+            return input.ReadString();
+        case ColorType::RGB: {
+            const auto red = input.Read<uint8_t>();
+            const auto green = input.Read<uint8_t>();
+            const auto blue = input.Read<uint8_t>();
+            return svg::Rgb{red, green, blue};
+        }
+        case ColorType::RGBA: {
+            const auto red = input.Read<uint8_t>();
+            const auto green = input.Read<uint8_t>();
+            const auto blue = input.Read<uint8_t>();
+            const auto opacity = input.Read<double>();
+            return svg::Rgba{red, green, blue, opacity};
+        }
+    }
+    throw std::runtime_error("Unknown color type in catalogue snapshot");
+}
+
+void WriteRenderSettings(Writer& output, const renderer::detail::RenderSettings& settings) {
+    output.Write(settings.width);
+    output.Write(settings.height);
+    output.Write(settings.padding);
+    output.Write(settings.line_width);
+    output.Write(settings.stop_radius);
+    output.Write(settings.bus_label_font_size);
+    output.Write(settings.bus_label_offset.x);
+    output.Write(settings.bus_label_offset.y);
+    output.Write(settings.stop_label_font_size);
+    output.Write(settings.stop_label_offset.x);
+    output.Write(settings.stop_label_offset.y);
+    WriteColor(output, settings.underlayer_color);
+    output.Write(settings.underlayer_width);
+    output.Write(static_cast<uint32_t>(settings.color_palette.size()));
+    for(const auto& color : settings.color_palette) {
+        WriteColor(output, color);
+    }
+}
+
+renderer::detail::RenderSettings ReadRenderSettings(Reader& input) {
+    renderer::detail::RenderSettings settings;
+    settings.width = input.Read<double>();
+    settings.height = input.Read<double>();
+    settings.padding = input.Read<double>();
+    settings.line_width = input.Read<double>();
+    settings.stop_radius = input.Read<double>();
+    settings.bus_label_font_size = input.Read<int>();
+    settings.bus_label_offset.x = input.Read<double>();
+    settings.bus_label_offset.y = input.Read<double>();
+    settings.stop_label_font_size = input.Read<int>();
+    settings.stop_label_offset.x = input.Read<double>();
+    settings.stop_label_offset.y = input.Read<double>();
+    settings.underlayer_color = ReadColor(input);
+    settings.underlayer_width = input.Read<double>();
+    settings.color_palette.resize(input.Read<uint32_t>());
+    for(auto& color : settings.color_palette) {
+        color = ReadColor(input);
+    }
+    return settings;
+}
+
+void WritePerfectHash(Writer& output, const catalogue::PerfectHashFunction::Data& hash) {
+    output.Write(hash.seed);
+    output.Write(hash.size);
+    output.Write(hash.table_size);
+    output.WriteArray(hash.pilots);
+    output.WriteArray(hash.remap);
+}
+
+catalogue::PerfectHashFunction::Data ReadPerfectHash(Reader& input) {
+    catalogue::PerfectHashFunction::Data hash;
+    hash.seed = input.Read<uint64_t>();
+    hash.size = input.Read<uint64_t>();
+    hash.table_size = input.Read<uint64_t>();
+    hash.pilots = input.ReadArray<uint64_t>();
+    hash.remap = input.ReadArray<uint32_t>();
+    return hash;
+}
+
+void WriteIndexes(Writer& output, const catalogue::FrozenIndexes& indexes) {
+    WritePerfectHash(output, indexes.stops_hash);
+    output.WriteArray(indexes.stops_by_slot);
+    WritePerfectHash(output, indexes.buses_hash);
+    output.WriteArray(indexes.buses_by_slot);
+    output.WriteArray(indexes.stops_index.points);
+    output.WriteArray(indexes.stops_index.ids);
+    output.WriteArray(indexes.stops_index.coords);
+    output.WriteArray(indexes.stops_index.axes);
+    output.WriteArray(indexes.stops_names_index.chars);
+    output.WriteArray(indexes.stops_names_index.offsets);
+    output.WriteArray(indexes.stops_names_index.ids);
+    output.WriteArray(indexes.stops_names_index.lcp);
+    output.WriteArray(indexes.stops_names_index.next_smaller);
+    output.Write(indexes.stops_names_index.max_length);
+}
+
+// читает индексы; их внутреннюю согласованность проверяют конструкторы индексов в Attach
+catalogue::FrozenIndexes ReadIndexes(Reader& input, size_t stops_count, size_t buses_count) {
+    catalogue::FrozenIndexes indexes;
+    indexes.stops_hash = ReadPerfectHash(input);
+    indexes.stops_by_slot = input.ReadArray<domain::StopId>();
+    indexes.buses_hash = ReadPerfectHash(input);
+    indexes.buses_by_slot = input.ReadArray<domain::BusId>();
+    indexes.stops_index.points = input.ReadArray<geo::SpherePoint>();
+    indexes.stops_index.ids = input.ReadArray<domain::StopId>();
+    indexes.stops_index.coords = input.ReadArray<geo::CompactCoordinates>();
+    indexes.stops_index.axes = input.ReadArray<uint8_t>();
+    indexes.stops_names_index.chars = input.ReadArray<char>();
+    indexes.stops_names_index.offsets = input.ReadArray<uint32_t>();
+    indexes.stops_names_index.ids = input.ReadArray<domain::StopId>();
+    indexes.stops_names_index.lcp = input.ReadArray<uint32_t>();
+    indexes.stops_names_index.next_smaller = input.ReadArray<uint32_t>();
+    indexes.stops_names_index.max_length = input.Read<uint64_t>();
+
+    // ячейки хеш-функции читаются без проверки границ, поэтому их ровно столько, сколько ключей
+    if(indexes.stops_by_slot.size() != indexes.stops_hash.size
+       || indexes.buses_by_slot.size() != indexes.buses_hash.size) {
+        throw std::runtime_error("Broken perfect hash in catalogue snapshot");
+    }
+    CheckIds(indexes.stops_by_slot, stops_count);
+    CheckIds(indexes.buses_by_slot, buses_count);
+    CheckIds(indexes.stops_index.ids, stops_count);
+    CheckIds(indexes.stops_names_index.ids, stops_count);
+    return indexes;
+}
+
+void WriteRouterData(Writer& output, const router::RouterData& data) {
+    output.WriteArray(data.graph.edges);
+    output.WriteArray(data.graph.incidence_offsets);
+    output.WriteArray(data.graph.incidence);
+    output.WriteArray(data.routes);
+}
+
+// читает граф и таблицу маршрутизатора; их согласованность проверяет конструктор TransportRouter
+router::RouterData ReadRouterData(Reader& input) {
+    router::RouterData data;
+    data.graph.edges = input.ReadArray<graph::Edge<router::TravelTime>>();
+    data.graph.incidence_offsets = input.ReadArray<uint64_t>();
+    data.graph.incidence = input.ReadArray<graph::EdgeId>();
+    data.routes = input.ReadArray<graph::Router<router::TravelTime>::RouteInternalData>();
+    return data;
+}
+}  // namespace
+
+// Формат снимка: заголовок (MAGIC, VERSION), затем массивы FrozenData в порядке объявления полей
+// (число элементов uint64, выравнивание до ALIGNMENT, элементы), индексы FrozenIndexes, настройки
+// отрисовки и построения маршрутов, граф и таблица кратчайших путей маршрутизатора
+void Save(std::ostream& output, const catalogue::TransportCatalogue& catalogue, const BaseSettings& settings) {
+    Writer writer(output);
+    writer.WriteBytes(MAGIC, sizeof(MAGIC));
+    writer.Write(VERSION);
+
+    std::vector<uint32_t> stops_names_offsets{0};
+    std::string stops_names;
+    std::vector<geo::CompactCoordinates> coords;
+    coords.reserve(catalogue.GetStopsCount());
+    for(domain::StopId id = 0; id < catalogue.GetStopsCount(); ++id) {
+        const domain::Stop* stop = catalogue.GetStopById(id);
+        stops_names += stop->name;
+        stops_names_offsets.push_back(static_cast<uint32_t>(stops_names.size()));
+        coords.push_back(stop->coord);
+    }
+
+    std::vector<uint32_t> buses_names_offsets{0};
+    std::string buses_names;
+    std::vector<uint8_t> is_roundtrip;
+    std::vector<uint32_t> stops_offsets{0};
+    std::vector<domain::StopId> stops;
+    std::vector<domain::BusStats> stats;
+    for(domain::BusId id = 0; id < catalogue.GetBusesCount(); ++id) {
+        const domain::Bus* bus = catalogue.GetBusById(id);
+        buses_names += bus->name;
+        buses_names_offsets.push_back(static_cast<uint32_t>(buses_names.size()));
+        is_roundtrip.push_back(bus->is_roundtrip);
+        stops.insert(stops.end(), bus->stops.begin(), bus->stops.end());
+        stops_offsets.push_back(static_cast<uint32_t>(stops.size()));
+        stats.push_back(catalogue.GetRouteInfo(id));
+    }
+
+    writer.WriteArray<uint32_t>(stops_names_offsets);
+    writer.WriteArray<char>(stops_names);
+    writer.WriteArray<geo::CompactCoordinates>(coords);
+    writer.WriteArray<uint32_t>(buses_names_offsets);
+    writer.WriteArray<char>(buses_names);
+    writer.WriteArray<uint8_t>(is_roundtrip);
+    writer.WriteArray<uint32_t>(stops_offsets);
+    writer.WriteArray<domain::StopId>(stops);
+    writer.WriteArray<domain::BusStats>(stats);
+    writer.WriteArray(catalogue.GetStopBusesOffsets());
+    writer.WriteArray(catalogue.GetStopBuses());
+    writer.WriteArray(catalogue.GetRoadDistances().GetOffsets());
+    writer.WriteArray(catalogue.GetRoadDistances().GetEntries());
+    WriteIndexes(writer, catalogue.GetFrozenIndexes());
+
+    WriteRenderSettings(writer, settings.render_settings);
+    writer.Write(settings.routing_settings.bus_velocity);
+    writer.Write(settings.routing_settings.bus_waiting_time);
+
+    const router::TransportRouter router(settings.routing_settings, catalogue);
+    WriteRouterData(writer, router.GetData());
+
+    if(!output) {
+        throw std::runtime_error("Failed to write catalogue snapshot");
+    }
+}
+
+BaseSettings Load(const std::filesystem::path& file, catalogue::TransportCatalogue& catalogue) {
+    auto mapped_file = std::make_shared<MappedFile>(file);
+    Reader reader(mapped_file->GetData());
+
+    const std::byte* magic = reader.Take(sizeof(MAGIC));
+    if(std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::runtime_error("Input is not a catalogue snapshot");
+    }
+    if(reader.Read<uint32_t>() != VERSION) {
+        throw std::runtime_error("Unsupported catalogue snapshot version");
+    }
+
+    catalogue::FrozenData data;
+    data.stops_names_offsets = reader.ReadArray<uint32_t>();
+    data.stops_names = reader.ReadArray<char>();
+    data.stops_coords = reader.ReadArray<geo::CompactCoordinates>();
+    data.buses_names_offsets = reader.ReadArray<uint32_t>();
+    data.buses_names = reader.ReadArray<char>();
+    data.buses_roundtrip = reader.ReadArray<uint8_t>();
+    data.buses_stops_offsets = reader.ReadArray<uint32_t>();
+    data.buses_stops = reader.ReadArray<domain::StopId>();
+    data.buses_stats = reader.ReadArray<domain::BusStats>();
+    data.stop_buses_offsets = reader.ReadArray<uint32_t>();
+    data.stop_buses = reader.ReadArray<domain::BusId>();
+    data.distances_offsets = reader.ReadArray<uint32_t>();
+    data.distances = reader.ReadArray<catalogue::RoadDistances::Entry>();
+
+    // проверяем согласованность массивов, чтобы справочник мог обращаться к ним без проверок
+    const size_t stops_count = data.stops_coords.size();
+    const size_t buses_count = data.buses_stats.size();
+    CheckOffsets(data.stops_names_offsets, stops_count, data.stops_names.size());
+    CheckOffsets(data.buses_names_offsets, buses_count, data.buses_names.size());
+    CheckOffsets(data.buses_stops_offsets, buses_count, data.buses_stops.size());
+    CheckOffsets(data.stop_buses_offsets, stops_count, data.stop_buses.size());
+    if(data.buses_roundtrip.size() != buses_count || data.distances_offsets.empty()
+       || data.distances_offsets.size() > stops_count + 1) {
+        throw std::runtime_error("Broken catalogue snapshot");
+    }
+    CheckOffsets(data.distances_offsets, data.distances_offsets.size() - 1, data.distances.size());
+    CheckIds(data.buses_stops, stops_count);
+    CheckIds(data.stop_buses, buses_count);
+    for(const auto& entry : data.distances) {
+        if(entry.to >= stops_count) {
+            throw std::runtime_error("Unknown id in catalogue snapshot");
+        }
+    }
+
+    data.indexes = ReadIndexes(reader, stops_count, buses_count);
+
+    BaseSettings settings;
+    settings.render_settings = ReadRenderSettings(reader);
+    settings.routing_settings.bus_velocity = reader.Read<double>();
+    settings.routing_settings.bus_waiting_time = reader.Read<int>();
+    settings.router_data = ReadRouterData(reader);
+
+    catalogue.Attach(data, std::move(mapped_file));
+    return settings;
+}
+
+}  // namespace serialization
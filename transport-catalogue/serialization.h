@@ -0,0 +1,39 @@
+#pragma once
+
+#include <filesystem>
+#include <iostream>
+#include <optional>
+
+#include "map_renderer.h"
+#include "transport_catalogue.h"
+#include "transport_router.h"
+
+namespace serialization {
+
+// Двоичный снимок справочника: упакованные массивы замороженного справочника (catalogue::FrozenData)
+// вместе с его поисковыми индексами, настройки отрисовки и построения маршрутов, граф и таблица
+// кратчайших путей маршрутизатора. Массивы выровнены и не содержат указателей, поэтому
+// загруженный справочник работает с ними прямо в отображённом в память файле: процессы, загрузившие
+// один снимок, делят одну физическую копию данных. Числа записываются в порядке байт платформы
+struct SerializationSettings {
+    std::filesystem::path file;
+};
+
+// настройки, сохраняемые вместе со справочником
+struct BaseSettings {
+    renderer::detail::RenderSettings render_settings;
+    router::RoutingSettings routing_settings;
+    // граф и таблица маршрутизатора из снимка; при сохранении не используются
+    std::optional<router::RouterData> router_data;
+};
+
+// записывает снимок замороженного справочника и настроек в output; маршрутизатор строится по справочнику
+void Save(std::ostream& output, const catalogue::TransportCatalogue& catalogue, const BaseSettings& settings);
+
+// отображает файл снимка в память, подключает его к пустому справочнику (справочник становится
+// замороженным и владеет отображением) и возвращает сохранённые настройки и данные маршрутизатора,
+// которые ссылаются на то же отображение;
+// при повреждённом снимке или несовпадении версии выбрасывает std::runtime_error
+BaseSettings Load(const std::filesystem::path& file, catalogue::TransportCatalogue& catalogue);
+
+}  // namespace serialization
@@ -0,0 +1,255 @@
+#include "spatial_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <numeric>
+#include <stdexcept>
+
+namespace catalogue {
+
+namespace {
+
+const double DR = std::numbers::pi / 180.;
+// запас на погрешность округления при сравнении с границами параллелепипеда
+const double EPSILON = 1e-12;
+
+// координата точки по оси разбиения: 0 - x, 1 - y, 2 - z
+double GetAxis(const geo::SpherePoint& point, uint8_t axis) {
+    return axis == 0 ? point.x : axis == 1 ? point.y : point.z;
+}
+
+// квадрат хорды между точками единичной сферы
+double GetChord2(const geo::SpherePoint& lhs, const geo::SpherePoint& rhs) {
+    const double dx = lhs.x - rhs.x;
+    const double dy = lhs.y - rhs.y;
+    const double dz = lhs.z - rhs.z;
+    return dx * dx + dy * dy + dz * dz;
+}
+
+// поддеревья не больше этого размера просматриваются без спуска
+const size_t LEAF_SIZE = 8;
+
+// добавляет узел pos в кучу кандидатов, если он ближе худшего из них
+void AddCandidate(double chord2, size_t pos, size_t count, double max_chord2,
+                  std::vector<std::pair<double, size_t>>& heap) {
+    if(chord2 > max_chord2) {
+        return;
+    }
+    if(heap.size() < count) {
+        heap.emplace_back(chord2, pos);
+        std::push_heap(heap.begin(), heap.end());
+    } else if(chord2 < heap.front().first) {
+        std::pop_heap(heap.begin(), heap.end());
+        heap.back() = {chord2, pos};
+        std::push_heap(heap.begin(), heap.end());
+    }
+}
+
+// лежат ли координаты в прямоугольнике [min, max] (min.lng <= max.lng)
+bool IsInside(geo::Coordinates coord, geo::Coordinates min, geo::Coordinates max) {
+    return min.lat <= coord.lat && coord.lat <= max.lat && min.lng <= coord.lng && coord.lng <= max.lng;
+}
+}  // namespace
+
+SpatialIndex::SpatialIndex(const std::vector<geo::CompactCoordinates>& coords) {
+    std::vector<geo::SpherePoint> points;
+    points.reserve(coords.size());
+    for(const auto& coord : coords) {
+        points.push_back(geo::ToSpherePoint(coord));
+    }
+    std::vector<domain::StopId> ids(coords.size());
+    std::vector<uint8_t> axes(coords.size());
+    std::iota(ids.begin(), ids.end(), domain::StopId{0});
+    Build(points, ids, axes, 0, ids.size());
+
+    // раскладываем точки и координаты в порядке узлов дерева
+    std::vector<geo::SpherePoint> tree_points;
+    std::vector<geo::CompactCoordinates> tree_coords;
+    tree_points.reserve(ids.size());
+    tree_coords.reserve(ids.size());
+    for(domain::StopId id : ids) {
+        tree_points.push_back(points[id]);
+        tree_coords.push_back(coords[id]);
+    }
+    points_ = FrozenArray<geo::SpherePoint>(std::move(tree_points));
+    ids_ = FrozenArray<domain::StopId>(std::move(ids));
+    coords_ = FrozenArray<geo::CompactCoordinates>(std::move(tree_coords));
+    axes_ = FrozenArray<uint8_t>(std::move(axes));
+}
+
+// использует готовое упакованное представление из чужой памяти
+SpatialIndex::SpatialIndex(const Data& data)
+    : points_(data.points)
+    , ids_(data.ids)
+    , coords_(data.coords)
+    , axes_(data.axes) {
+    const size_t size = data.points.size();
+    if(data.ids.size() != size || data.coords.size() != size || data.axes.size() != size
+       || std::any_of(data.axes.begin(), data.axes.end(), [](uint8_t axis) { return axis > 2; })) {
+        throw std::runtime_error("Broken spatial index");
+    }
+}
+
+SpatialIndex::Data SpatialIndex::GetData() const {
+    return {points_.GetView(), ids_.GetView(), coords_.GetView(), axes_.GetView()};
+}
+
+// упорядочивает ids на отрезке [begin, end): медиана по оси наибольшего разброса
+// становится корнем, меньшие точки - левым поддеревом, большие - правым
+void SpatialIndex::Build(const std::vector<geo::SpherePoint>& points, std::vector<domain::StopId>& ids,
+                         std::vector<uint8_t>& axes, size_t begin, size_t end) {
+    if(end - begin <= LEAF_SIZE) {
+        return;
+    }
+    double min[3] = {2., 2., 2.};
+    double max[3] = {-2., -2., -2.};
+    for(size_t i = begin; i < end; ++i) {
+        for(uint8_t axis = 0; axis < 3; ++axis) {
+            const double value = GetAxis(points[ids[i]], axis);
+            min[axis] = std::min(min[axis], value);
+            max[axis] = std::max(max[axis], value);
+        }
+    }
+    uint8_t axis = 0;
+    for(uint8_t i = 1; i < 3; ++i) {
+        if(max[i] - min[i] > max[axis] - min[axis]) {
+            axis = i;
+        }
+    }
+
+    const size_t mid = begin + (end - begin) / 2;
+    std::nth_element(ids.begin() + begin, ids.begin() + mid, ids.begin() + end,
+                     [&points, axis](domain::StopId lhs, domain::StopId rhs) {
+        return GetAxis(points[lhs], axis) < GetAxis(points[rhs], axis);
+    });
+    axes[mid] = axis;
+    Build(points, ids, axes, begin, mid);
+    Build(points, ids, axes, mid + 1, end);
+}
+
+std::vector<SpatialIndex::Neighbor> SpatialIndex::FindNearest(geo::Coordinates point, size_t count,
+                                                             double radius) const {
+    std::vector<Neighbor> result;
+    if(count == 0 || radius < 0 || points_.empty()) {
+        return result;
+    }
+    // радиус в метрах переводим в квадрат хорды единичной сферы
+    const double angle = std::min(radius / geo::EARTH_RADIUS, std::numbers::pi);
+    const double chord = 2. * std::sin(angle / 2.);
+    const geo::SpherePoint query = geo::ToSpherePoint(point);
+
+    // куча с наибольшим расстоянием на вершине: пары (квадрат хорды, позиция узла)
+    std::vector<std::pair<double, size_t>> heap;
+    heap.reserve(std::min(count, points_.size()));
+    SearchNearest(0, points_.size(), query, count, chord * chord + EPSILON, heap);
+
+    std::sort_heap(heap.begin(), heap.end());
+    result.reserve(heap.size());
+    for(const auto& [chord2, pos] : heap) {
+        result.push_back({ids_[pos], geo::ComputeDistance(query, points_[pos])});
+    }
+    return result;
+}
+
+void SpatialIndex::SearchNearest(size_t begin, size_t end, const geo::SpherePoint& query, size_t count,
+                                 double max_chord2, std::vector<std::pair<double, size_t>>& heap) const {
+    // небольшие поддеревья дешевле просмотреть целиком
+    if(end - begin <= LEAF_SIZE) {
+        for(size_t pos = begin; pos < end; ++pos) {
+            AddCandidate(GetChord2(query, points_[pos]), pos, count, max_chord2, heap);
+        }
+        return;
+    }
+    const size_t mid = begin + (end - begin) / 2;
+    AddCandidate(GetChord2(query, points_[mid]), mid, count, max_chord2, heap);
+
+    // сначала обходим поддерево со стороны запроса, дальнее - только если разделяющая
+    // плоскость ближе текущего худшего кандидата
+    const uint8_t axis = axes_[mid];
+    const double diff = GetAxis(query, axis) - GetAxis(points_[mid], axis);
+    const bool left_first = diff < 0;
+    SearchNearest(left_first ? begin : mid + 1, left_first ? mid : end, query, count, max_chord2, heap);
+    const double bound = heap.size() < count ? max_chord2 : heap.front().first;
+    if(diff * diff <= bound) {
+        SearchNearest(left_first ? mid + 1 : begin, left_first ? end : mid, query, count, max_chord2, heap);
+    }
+}
+
+std::vector<domain::StopId> SpatialIndex::FindInBox(geo::Coordinates min, geo::Coordinates max) const {
+    std::vector<domain::StopId> result;
+    if(min.lat > max.lat || points_.empty()) {
+        return result;
+    }
+    // прямоугольник через 180-й меридиан разбиваем на два
+    if(min.lng > max.lng) {
+        SearchBox(0, points_.size(), GetBoundingBox(min, {max.lat, 180.}), min, {max.lat, 180.}, result);
+        SearchBox(0, points_.size(), GetBoundingBox({min.lat, -180.}, max), {min.lat, -180.}, max, result);
+    } else {
+        SearchBox(0, points_.size(), GetBoundingBox(min, max), min, max, result);
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+void SpatialIndex::SearchBox(size_t begin, size_t end, const Box& box, geo::Coordinates min,
+                             geo::Coordinates max, std::vector<domain::StopId>& result) const {
+    if(end - begin <= LEAF_SIZE) {
+        for(size_t pos = begin; pos < end; ++pos) {
+            if(IsInside(coords_[pos], min, max)) {
+                result.push_back(ids_[pos]);
+            }
+        }
+        return;
+    }
+    const size_t mid = begin + (end - begin) / 2;
+    if(IsInside(coords_[mid], min, max)) {
+        result.push_back(ids_[mid]);
+    }
+    const uint8_t axis = axes_[mid];
+    const double value = GetAxis(points_[mid], axis);
+    if(box.min[axis] <= value) {
+        SearchBox(begin, mid, box, min, max, result);
+    }
+    if(value <= box.max[axis]) {
+        SearchBox(mid + 1, end, box, min, max, result);
+    }
+}
+
+// z = sin(lat), x = cos(lat) * cos(lng), y = cos(lat) * sin(lng); экстремумы достигаются
+// на границах прямоугольника либо на экваторе и меридианах 0, ±90, ±180
+SpatialIndex::Box SpatialIndex::GetBoundingBox(geo::Coordinates min, geo::Coordinates max) {
+    const double lat_min = std::max(min.lat, -90.) * DR;
+    const double lat_max = std::min(max.lat, 90.) * DR;
+    const double lng_min = min.lng * DR;
+    const double lng_max = max.lng * DR;
+    const auto contains_lng = [&min, &max](double lng) {
+        return min.lng <= lng && lng <= max.lng;
+    };
+
+    const double cos_lat_min = std::min(std::cos(lat_min), std::cos(lat_max));
+    const double cos_lat_max = min.lat <= 0. && 0. <= max.lat
+        ? 1. : std::max(std::cos(lat_min), std::cos(lat_max));
+    const double cos_lng_min = contains_lng(-180.) || contains_lng(180.)
+        ? -1. : std::min(std::cos(lng_min), std::cos(lng_max));
+    const double cos_lng_max = contains_lng(0.) ? 1. : std::max(std::cos(lng_min), std::cos(lng_max));
+    const double sin_lng_min = contains_lng(-90.) ? -1. : std::min(std::sin(lng_min), std::sin(lng_max));
+    const double sin_lng_max = contains_lng(90.) ? 1. : std::max(std::sin(lng_min), std::sin(lng_max));
+
+    // произведение с неотрицательным cos(lat) экстремально на одной из границ его диапазона
+    Box box;
+    box.min[0] = std::min(cos_lat_min * cos_lng_min, cos_lat_max * cos_lng_min) - EPSILON;
+    box.max[0] = std::max(cos_lat_min * cos_lng_max, cos_lat_max * cos_lng_max) + EPSILON;
+    box.min[1] = std::min(cos_lat_min * sin_lng_min, cos_lat_max * sin_lng_min) - EPSILON;
+    box.max[1] = std::max(cos_lat_min * sin_lng_max, cos_lat_max * sin_lng_max) + EPSILON;
+    box.min[2] = std::sin(lat_min) - EPSILON;
+    box.max[2] = std::sin(lat_max) + EPSILON;
+    return box;
+}
+
+size_t SpatialIndex::GetMemoryUsage() const {
+    return points_.GetMemoryUsage() + ids_.GetMemoryUsage() + coords_.GetMemoryUsage() + axes_.GetMemoryUsage();
+}
+
+}  // namespace catalogue
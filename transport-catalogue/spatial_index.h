@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "domain.h"
+#include "frozen_array.h"
+#include "geo.h"
+
+namespace catalogue {
+
+// Статический пространственный индекс остановок: сбалансированное k-d дерево по точкам
+// единичной сферы. Хорда между точками монотонна по расстоянию вдоль поверхности,
+// поэтому отсечение по разделяющей плоскости точное и не зависит от перехода через 180-й меридиан.
+// Дерево хранится неявно: медиана отрезка [begin, end) - корень его поддерева.
+class SpatialIndex {
+public:
+    struct Neighbor {
+        domain::StopId id;
+        double distance;  // в метрах
+    };
+
+    // упакованное представление: узлы дерева в порядке обхода, без указателей,
+    // поэтому может лежать в файле снимка
+    struct Data {
+        std::span<const geo::SpherePoint> points;
+        std::span<const domain::StopId> ids;
+        std::span<const geo::CompactCoordinates> coords;
+        std::span<const uint8_t> axes;
+    };
+
+    SpatialIndex() = default;
+    // строит индекс по координатам остановок, индекс в векторе - id остановки
+    explicit SpatialIndex(const std::vector<geo::CompactCoordinates>& coords);
+    // использует готовое упакованное представление из чужой памяти, которая должна жить дольше индекса;
+    // при несогласованных размерах массивов или неверной оси выбрасывает std::runtime_error
+    explicit SpatialIndex(const Data& data);
+
+    Data GetData() const;
+
+    // возвращает не более count ближайших к point остановок в пределах radius метров,
+    // упорядоченных по возрастанию расстояния
+    std::vector<Neighbor> FindNearest(geo::Coordinates point, size_t count, double radius) const;
+
+    // возвращает остановки, попадающие в прямоугольник координат [min, max];
+    // при min.lng > max.lng прямоугольник пересекает 180-й меридиан
+    std::vector<domain::StopId> FindInBox(geo::Coordinates min, geo::Coordinates max) const;
+
+    // приблизительный объём занятой памяти в байтах
+    size_t GetMemoryUsage() const;
+
+private:
+    // ограничивающий параллелепипед в декартовых координатах
+    struct Box {
+        double min[3];
+        double max[3];
+    };
+
+    // упорядочивает ids на отрезке [begin, end) и заполняет axes
+    static void Build(const std::vector<geo::SpherePoint>& points, std::vector<domain::StopId>& ids,
+                      std::vector<uint8_t>& axes, size_t begin, size_t end);
+
+    void SearchNearest(size_t begin, size_t end, const geo::SpherePoint& query, size_t count,
+                       double max_chord2, std::vector<std::pair<double, size_t>>& heap) const;
+    void SearchBox(size_t begin, size_t end, const Box& box, geo::Coordinates min, geo::Coordinates max,
+                   std::vector<domain::StopId>& result) const;
+
+    // возвращает ограничивающий параллелепипед сферического прямоугольника (min.lng <= max.lng)
+    static Box GetBoundingBox(geo::Coordinates min, geo::Coordinates max);
+
+    // узлы дерева в порядке обхода: точка, id остановки, её координаты и ось разбиения
+    FrozenArray<geo::SpherePoint> points_;
+    FrozenArray<domain::StopId> ids_;
+    FrozenArray<geo::CompactCoordinates> coords_;
+    FrozenArray<uint8_t> axes_;
+};
+
+}  // namespace catalogue
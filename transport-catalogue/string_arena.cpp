@@ -0,0 +1,80 @@
+#include "string_arena.h"
+#include "memory_usage.h"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+
+namespace catalogue {
+
+// возвращает стабильную копию строки str из хранилища
+std::string_view StringArena::Intern(std::string_view str) {
+    if(str.empty()) {
+        return {};
+    }
+    if(2 * (index_size_ + 1) > index_.size()) {
+        GrowIndex();
+    }
+    const size_t slot = FindSlot(str);
+    if(index_[slot].empty()) {
+        index_[slot] = Append(str);
+        ++index_size_;
+    }
+    return index_[slot];
+}
+
+// освобождает индекс повторов, после вызова строки больше не объединяются
+void StringArena::ReleaseIndex() {
+    std::vector<std::string_view>{}.swap(index_);
+    index_size_ = 0;
+}
+
+// количество байт, занятых блоками хранилища
+size_t StringArena::GetCapacity() const {
+    return std::accumulate(blocks_sizes_.begin(), blocks_sizes_.end(), size_t{0});
+}
+
+size_t StringArena::GetMemoryUsage() const {
+    return GetCapacity() + memory::GetUsage(blocks_) + memory::GetUsage(blocks_sizes_) + memory::GetUsage(index_);
+}
+
+// копирует строку в текущий блок, при нехватке места заводит новый
+std::string_view StringArena::Append(std::string_view str) {
+    if(str.empty()) {
+        return {};
+    }
+    if(blocks_.empty() || blocks_sizes_.back() - used_in_last_ < str.size()) {
+        // длинные строки получают собственный блок
+        size_t size = std::max(BLOCK_SIZE, str.size());
+        blocks_.push_back(std::make_unique_for_overwrite<char[]>(size));
+        blocks_sizes_.push_back(size);
+        used_in_last_ = 0;
+    }
+    char* dest = blocks_.back().get() + used_in_last_;
+    std::copy(str.begin(), str.end(), dest);
+    used_in_last_ += str.size();
+    return {dest, str.size()};
+}
+
+// ячейка индекса, в которой лежит строка str, или пустая ячейка для её вставки
+size_t StringArena::FindSlot(std::string_view str) const {
+    const size_t mask = index_.size() - 1;
+    size_t slot = std::hash<std::string_view>{}(str) & mask;
+    while(!index_[slot].empty() && index_[slot] != str) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+// увеличивает индекс вдвое и раскладывает строки заново
+void StringArena::GrowIndex() {
+    std::vector<std::string_view> old(std::max(MIN_INDEX_SIZE, 2 * index_.size()));
+    old.swap(index_);
+    for(std::string_view str : old) {
+        if(!str.empty()) {
+            index_[FindSlot(str)] = str;
+        }
+    }
+}
+
+}  // namespace catalogue
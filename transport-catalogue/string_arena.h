@@ -0,0 +1,47 @@
+#pragma once
+
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace catalogue {
+
+// Хранилище строк: строки копируются в большие непрерывные блоки памяти,
+// которые только добавляются и никогда не перемещаются, поэтому string_view на них стабильны.
+// Одинаковые строки хранятся в единственном экземпляре.
+class StringArena {
+public:
+    // возвращает стабильную копию строки str из хранилища
+    std::string_view Intern(std::string_view str);
+
+    // освобождает индекс повторов, после вызова строки больше не объединяются
+    void ReleaseIndex();
+
+    // количество байт, занятых блоками хранилища
+    size_t GetCapacity() const;
+
+    // приблизительный объём занятой памяти в байтах вместе с индексом повторов
+    size_t GetMemoryUsage() const;
+
+private:
+    // копирует строку в текущий блок, при нехватке места заводит новый
+    std::string_view Append(std::string_view str);
+    // ячейка индекса, в которой лежит строка str, или пустая ячейка для её вставки
+    size_t FindSlot(std::string_view str) const;
+    // увеличивает индекс вдвое и раскладывает строки заново
+    void GrowIndex();
+
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+    // начальный размер индекса, степень двойки
+    static constexpr size_t MIN_INDEX_SIZE = 64;
+
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    std::vector<size_t> blocks_sizes_;
+    size_t used_in_last_ = 0;
+    // уже сохранённые строки: открытая адресация с линейным пробированием, пустая строка - свободная ячейка.
+    // Индекс заполнен не больше чем наполовину, поэтому на каждое название не заводится отдельный узел
+    std::vector<std::string_view> index_;
+    size_t index_size_ = 0;
+};
+
+}  // namespace catalogue
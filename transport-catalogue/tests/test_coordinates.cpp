@@ -0,0 +1,220 @@
+#include <algorithm>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "geo.h"
+#include "map_renderer.h"
+#include "transport_catalogue.h"
+#include "testing.h"
+
+using namespace catalogue;
+using namespace std::literals;
+
+namespace {
+
+// Регрессия точности хранения координат в целых микроградусах: кривизна маршрутов
+// и координаты на карте сравниваются с расчётом по исходным координатам в double.
+// Координаты с 6 знаками после запятой хранятся точно, и результат совпадает с прежним
+// до погрешности формул. У более точных координат округление сдвигает точку не более чем
+// на 0.5 микроградуса по каждой оси, отсюда допуски ниже
+
+// относительное расхождение кривизны, когда координаты хранятся точно
+// (кривизна считается через точки на единичной сфере, эталон - через широту и долготу)
+const double EXACT_CURVATURE_TOLERANCE = 1e-9;
+// наибольший сдвиг точки при округлении: 0.5 микроградуса по широте и долготе, м
+const double MAX_ROUNDING_SHIFT = 0.5e-6 * 3.14159265358979 / 180 * geo::EARTH_RADIUS * 1.4142135623731;
+
+const double MAP_SIZE = 1200;
+const double MAP_PADDING = 50;
+
+struct SampleStop {
+    std::string name;
+    geo::Coordinates coord;
+};
+
+struct SampleBus {
+    std::string name;
+    std::vector<std::string_view> stops;
+    bool is_roundtrip;
+};
+
+// пример входных данных из описания формата
+const std::vector<SampleStop> SAMPLE_STOPS = {
+    {"Tolstopaltsevo"s, {55.611087, 37.20829}},
+    {"Marushkino"s, {55.595884, 37.209755}},
+    {"Rasskazovka"s, {55.632761, 37.333324}},
+    {"Biryulyovo Zapadnoye"s, {55.574371, 37.6517}},
+    {"Biryusinka"s, {55.581065, 37.64839}},
+    {"Universam"s, {55.587655, 37.645687}},
+    {"Biryulyovo Tovarnaya"s, {55.592028, 37.653656}},
+    {"Biryulyovo Passazhirskaya"s, {55.580999, 37.659164}},
+    {"Rossoshanskaya ulitsa"s, {55.595579, 37.605757}},
+    {"Prazhskaya"s, {55.611678, 37.603831}},
+};
+
+const std::vector<DistanceDescription> SAMPLE_DISTANCES = {
+    {"Tolstopaltsevo"sv, "Marushkino"sv, 3900},
+    {"Marushkino"sv, "Rasskazovka"sv, 9900},
+    {"Marushkino"sv, "Marushkino"sv, 100},
+    {"Rasskazovka"sv, "Marushkino"sv, 9500},
+    {"Biryulyovo Zapadnoye"sv, "Rossoshanskaya ulitsa"sv, 7500},
+    {"Biryulyovo Zapadnoye"sv, "Biryusinka"sv, 1800},
+    {"Biryulyovo Zapadnoye"sv, "Universam"sv, 2400},
+    {"Biryusinka"sv, "Universam"sv, 750},
+    {"Universam"sv, "Rossoshanskaya ulitsa"sv, 5600},
+    {"Universam"sv, "Biryulyovo Tovarnaya"sv, 900},
+    {"Biryulyovo Tovarnaya"sv, "Biryulyovo Passazhirskaya"sv, 1300},
+    {"Biryulyovo Passazhirskaya"sv, "Biryulyovo Zapadnoye"sv, 1200},
+};
+
+const std::vector<SampleBus> SAMPLE_BUSES = {
+    {"256"s, {"Biryulyovo Zapadnoye"sv, "Biryusinka"sv, "Universam"sv, "Biryulyovo Tovarnaya"sv,
+              "Biryulyovo Passazhirskaya"sv, "Biryulyovo Zapadnoye"sv}, true},
+    {"750"s, {"Tolstopaltsevo"sv, "Marushkino"sv, "Marushkino"sv, "Rasskazovka"sv}, false},
+    {"828"s, {"Biryulyovo Zapadnoye"sv, "Universam"sv, "Rossoshanskaya ulitsa"sv, "Biryulyovo Zapadnoye"sv}, true},
+};
+
+// те же остановки с координатами точнее микроградуса, которые округляются при хранении
+std::vector<SampleStop> MakePreciseStops() {
+    std::mt19937 generator(2024);
+    std::uniform_real_distribution<double> noise(-5e-7, 5e-7);
+    auto stops = SAMPLE_STOPS;
+    for(auto& stop : stops) {
+        stop.coord.lat += noise(generator);
+        stop.coord.lng += noise(generator);
+    }
+    return stops;
+}
+
+void FillCatalogue(TransportCatalogue& catalogue, const std::vector<SampleStop>& sample_stops) {
+    std::vector<Stop> stops;
+    for(const auto& stop : sample_stops) {
+        stops.push_back({stop.name, stop.coord});
+    }
+    std::vector<BusDescription> buses;
+    for(const auto& bus : SAMPLE_BUSES) {
+        buses.push_back({bus.name, bus.stops, bus.is_roundtrip});
+    }
+    catalogue.AddBulk(stops, SAMPLE_DISTANCES, buses);
+}
+
+struct ReferenceCurvature {
+    double curvature;
+    // допустимое расхождение при округлении координат: каждый отрезок меняет длину
+    // не более чем на два сдвига концов
+    double rounding_tolerance;
+};
+
+// кривизна по исходным координатам: фактическая длина, делённая на сумму расстояний по формуле с acos
+ReferenceCurvature ComputeReferenceCurvature(const TransportCatalogue& catalogue,
+                                             const std::vector<SampleStop>& sample_stops, const Bus& bus) {
+    const RouteStops route(bus);
+    double geo_length = 0;
+    size_t length = 0;
+    for(size_t i = 0; i + 1 < route.size(); ++i) {
+        const Stop* from = catalogue.GetStopById(route[i]);
+        const Stop* to = catalogue.GetStopById(route[i + 1]);
+        geo_length += geo::ComputeDistance(sample_stops[from->id].coord, sample_stops[to->id].coord);
+        length += catalogue.GetDistanceBetweenStops(from, to);
+    }
+    const double curvature = length / geo_length;
+    const double max_geo_error = (route.size() - 1) * 2 * MAX_ROUNDING_SHIFT;
+    return {curvature, curvature * max_geo_error / (geo_length - max_geo_error)};
+}
+
+void CheckCurvature(const std::vector<SampleStop>& sample_stops, bool is_exact) {
+    for(StatsMode mode : {StatsMode::EAGER, StatsMode::LAZY}) {
+        TransportCatalogue catalogue(mode);
+        FillCatalogue(catalogue, sample_stops);
+        for(const auto& sample_bus : SAMPLE_BUSES) {
+            const Bus* bus = catalogue.GetBus(sample_bus.name);
+            ASSERT(bus != nullptr);
+            const auto [reference, rounding_tolerance] = ComputeReferenceCurvature(catalogue, sample_stops, *bus);
+            ASSERT_NEAR(catalogue.GetRouteInfo(bus).curvature, reference,
+                        is_exact ? reference * EXACT_CURVATURE_TOLERANCE : rounding_tolerance);
+        }
+    }
+}
+
+// координаты, заданные не более чем с 6 знаками после запятой, восстанавливаются без потерь
+void TestExactRoundTrip() {
+    for(const auto& stop : SAMPLE_STOPS) {
+        ASSERT(geo::Coordinates(geo::CompactCoordinates(stop.coord)) == stop.coord);
+    }
+    const geo::Coordinates extremes[] = {{90.0, 180.0}, {-90.0, -180.0}, {0.000001, -0.000001}};
+    for(const auto& coord : extremes) {
+        ASSERT(geo::Coordinates(geo::CompactCoordinates(coord)) == coord);
+    }
+}
+
+void TestSampleCurvature() {
+    CheckCurvature(SAMPLE_STOPS, true);
+
+    // значения из примера ответов
+    TransportCatalogue catalogue;
+    FillCatalogue(catalogue, SAMPLE_STOPS);
+    ASSERT_NEAR(catalogue.GetRouteInfo(catalogue.GetBus("256"sv)).curvature, 1.36124, 1e-5);
+    ASSERT_NEAR(catalogue.GetRouteInfo(catalogue.GetBus("750"sv)).curvature, 1.30853, 1e-5);
+}
+
+void TestPreciseCurvature() {
+    CheckCurvature(MakePreciseStops(), false);
+}
+
+// проекция на карту по раскодированным координатам против проекции по исходным.
+// При точном хранении координаты на карте совпадают. Иначе сдвиг точки и крайних точек,
+// по которым выбирается масштаб, даёт не больше двух микроградусов в масштабе карты
+void CheckProjection(const std::vector<SampleStop>& sample_stops, bool is_exact) {
+    std::vector<geo::CompactCoordinates> compact;
+    for(const auto& stop : sample_stops) {
+        compact.push_back(stop.coord);
+    }
+    std::vector<const geo::Coordinates*> original_ptrs;
+    std::vector<const geo::CompactCoordinates*> compact_ptrs;
+    for(size_t i = 0; i < sample_stops.size(); ++i) {
+        original_ptrs.push_back(&sample_stops[i].coord);
+        compact_ptrs.push_back(&compact[i]);
+    }
+    const renderer::SphereProjector original(original_ptrs.begin(), original_ptrs.end(), MAP_SIZE, MAP_SIZE,
+                                             MAP_PADDING);
+    const renderer::SphereProjector decoded(compact_ptrs.begin(), compact_ptrs.end(), MAP_SIZE, MAP_SIZE,
+                                            MAP_PADDING);
+
+    // карта квадратная, масштаб задаёт больший из размахов по широте и долготе
+    const auto [min_lat, max_lat] = std::minmax_element(sample_stops.begin(), sample_stops.end(),
+        [](const SampleStop& lhs, const SampleStop& rhs) { return lhs.coord.lat < rhs.coord.lat; });
+    const auto [min_lng, max_lng] = std::minmax_element(sample_stops.begin(), sample_stops.end(),
+        [](const SampleStop& lhs, const SampleStop& rhs) { return lhs.coord.lng < rhs.coord.lng; });
+    const double zoom = (MAP_SIZE - 2 * MAP_PADDING)
+                        / std::max(max_lat->coord.lat - min_lat->coord.lat, max_lng->coord.lng - min_lng->coord.lng);
+    const double tolerance = is_exact ? 0 : 2e-6 * zoom;
+
+    for(size_t i = 0; i < sample_stops.size(); ++i) {
+        const svg::Point expected = original(sample_stops[i].coord);
+        const svg::Point actual = decoded(compact[i]);
+        ASSERT_NEAR(actual.x, expected.x, tolerance);
+        ASSERT_NEAR(actual.y, expected.y, tolerance);
+    }
+}
+
+void TestSampleProjection() {
+    CheckProjection(SAMPLE_STOPS, true);
+}
+
+void TestPreciseProjection() {
+    CheckProjection(MakePreciseStops(), false);
+}
+
+}  // namespace
+
+int main() {
+    bool ok = true;
+    ok &= RUN_TEST(TestExactRoundTrip);
+    ok &= RUN_TEST(TestSampleCurvature);
+    ok &= RUN_TEST(TestPreciseCurvature);
+    ok &= RUN_TEST(TestSampleProjection);
+    ok &= RUN_TEST(TestPreciseProjection);
+    return ok ? 0 : 1;
+}
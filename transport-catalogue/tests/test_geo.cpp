@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "geo.h"
+#include "testing.h"
+
+using namespace geo;
+
+namespace {
+
+// допустимое расхождение с формулой через широту и долготу на отрезке длины distance, м.
+// Обе формулы берут acos от числа, близкого к единице: ошибка округления аргумента ~2^-52
+// даёт ошибку длины ~R^2 * 2^-52 / distance (около 1 см на 1 м и 10 мкм на 1 км),
+// плюс относительная погрешность 1e-9
+double SegmentTolerance(double distance) {
+    return 1e-9 * distance + 0.1 / std::max(distance, 1.0);
+}
+
+std::vector<Coordinates> MakeCoordinates(std::mt19937& generator, size_t count, double lat_from, double lat_to,
+                                         double lng_from, double lng_to) {
+    std::uniform_real_distribution<double> lat(lat_from, lat_to);
+    std::uniform_real_distribution<double> lng(lng_from, lng_to);
+    std::vector<Coordinates> coords(count);
+    for(auto& coord : coords) {
+        // координаты во входных данных заданы не более чем с 6 знаками после запятой
+        coord = CompactCoordinates({lat(generator), lng(generator)});
+    }
+    return coords;
+}
+
+std::vector<SpherePoint> ToSpherePoints(const std::vector<Coordinates>& coords) {
+    std::vector<SpherePoint> points;
+    for(const auto& coord : coords) {
+        points.push_back(ToSpherePoint(coord));
+    }
+    return points;
+}
+
+// длина ломаной по прежней формуле, слагаемые в порядке движения, и сумма допусков отрезков
+std::pair<double, double> ComputeReferenceLength(const std::vector<Coordinates>& coords,
+                                                 const std::vector<uint32_t>& route, bool and_back) {
+    double length = 0;
+    double tolerance = 0;
+    auto add = [&](uint32_t from, uint32_t to) {
+        const double distance = ComputeDistance(coords[from], coords[to]);
+        length += distance;
+        tolerance += SegmentTolerance(distance);
+    };
+    for(size_t i = 0; i + 1 < route.size(); ++i) {
+        add(route[i], route[i + 1]);
+    }
+    if(and_back) {
+        for(size_t i = route.size(); i-- > 1;) {
+            add(route[i], route[i - 1]);
+        }
+    }
+    return {length, tolerance};
+}
+
+void TestSpherePointDistance() {
+    std::mt19937 generator(42);
+    // остановки одного города и точки по всему земному шару
+    for(const auto& coords : {MakeCoordinates(generator, 1000, 55.5, 56.0, 37.3, 37.9),
+                              MakeCoordinates(generator, 1000, -89.0, 89.0, -180.0, 180.0)}) {
+        const auto points = ToSpherePoints(coords);
+        for(size_t i = 0; i + 1 < coords.size(); ++i) {
+            const double reference = ComputeDistance(coords[i], coords[i + 1]);
+            ASSERT_NEAR(ComputeDistance(points[i], points[i + 1]), reference, SegmentTolerance(reference));
+        }
+        ASSERT_EQUAL(ComputeDistance(points[0], points[0]), 0.0);
+    }
+}
+
+// ближайшие точки: отрезки в несколько метров, где acos теряет больше всего знаков
+void TestShortSegments() {
+    const Coordinates from{55.611087, 37.20829};
+    for(int delta = 1; delta <= 100; ++delta) {
+        const Coordinates to{from.lat + delta * 1e-6, from.lng + delta * 1e-6};
+        const double reference = ComputeDistance(from, to);
+        ASSERT_NEAR(ComputeDistance(ToSpherePoint(from), ToSpherePoint(to)), reference, SegmentTolerance(reference));
+    }
+}
+
+void TestPathLength() {
+    std::mt19937 generator(7);
+    const auto coords = MakeCoordinates(generator, 200, 55.5, 56.0, 37.3, 37.9);
+    const auto points = ToSpherePoints(coords);
+    std::uniform_int_distribution<uint32_t> stop(0, coords.size() - 1);
+
+    // длины вокруг границ пакетов по четыре отрезка (AVX2) и по PATH_BATCH отрезков
+    for(size_t size : {0, 1, 2, 3, 4, 5, 6, 9, 63, 64, 65, 66, 129, 1000}) {
+        std::vector<uint32_t> route(size);
+        for(auto& id : route) {
+            id = stop(generator);
+        }
+        if(size > 3) {
+            // повтор остановки подряд даёт отрезок нулевой длины
+            route[2] = route[1];
+        }
+        for(bool and_back : {false, true}) {
+            const double scalar = ComputePathLength(points, route, and_back, PathKernel::SCALAR);
+            const auto [reference, tolerance] = ComputeReferenceLength(coords, route, and_back);
+            ASSERT_NEAR(scalar, reference, tolerance);
+            ASSERT_EQUAL(ComputePathLength(points, route, and_back), scalar);
+            if(IsSupported(PathKernel::AVX2)) {
+                ASSERT_EQUAL(ComputePathLength(points, route, and_back, PathKernel::AVX2), scalar);
+            }
+        }
+    }
+}
+
+}  // namespace
+
+int main() {
+    bool ok = true;
+    ok &= RUN_TEST(TestSpherePointDistance);
+    ok &= RUN_TEST(TestShortSegments);
+    ok &= RUN_TEST(TestPathLength);
+    if(!IsSupported(PathKernel::AVX2)) {
+        std::cerr << "AVX2 is not supported, the AVX2 kernel was not checked\n";
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "json.h"
+#include "json_writer.h"
+#include "testing.h"
+
+using namespace std::literals;
+
+namespace {
+
+// Числа при разборе (from_chars) и выводе (to_chars): значение, выведенное Writer и прочитанное
+// обратно, совпадает с исходным побитово, а каноническая запись числа выводится без изменений.
+// Числа, разорванные между блоками потокового разбора, читаются так же, как из буфера
+
+// размер блока, которым Parser читает поток (Parser::CHUNK_SIZE)
+const size_t STREAM_CHUNK_SIZE = 64 * 1024;
+
+std::vector<double> GetSpecialDoubles() {
+    using Limits = std::numeric_limits<double>;
+    return {0.0, -0.0, 1.0, -1.0, 0.1, -0.1, 1.0 / 3, 2.5, 1e-7, 123456.789,
+            Limits::denorm_min(), -Limits::denorm_min(), 2.2250738585072009e-308 /* наибольший денормализованный */,
+            Limits::min(), -Limits::min(), 1e308, -1e308, Limits::max(), -Limits::max(), Limits::epsilon(),
+            1e15, 1e16, 1e21, 123456789012345678.0, 2147483647.0, 2147483648.0, -2147483649.0, 4294967296.0};
+}
+
+std::vector<int> GetSpecialInts() {
+    using Limits = std::numeric_limits<int>;
+    return {0, 1, -1, 9, 10, -10, 123456, 1000000000, Limits::max(), Limits::min(), Limits::max() - 1,
+            Limits::min() + 1};
+}
+
+std::string PrintValue(const json::Node::Value& value) {
+    std::ostringstream output;
+    json::Writer(output).Value(value);
+    return output.str();
+}
+
+json::Node ParseValue(std::string_view text) {
+    return json::Load(text).GetRoot();
+}
+
+// побитовое сравнение, чтобы различать -0.0 и 0.0
+void CheckSameDouble(double value, double expected, std::string_view text) {
+    if(std::bit_cast<uint64_t>(value) != std::bit_cast<uint64_t>(expected)) {
+        std::ostringstream message;
+        message.precision(17);
+        message << "double " << expected << " printed as \"" << text << "\" was read as " << value;
+        throw testing::AssertionError(message.str());
+    }
+}
+
+// случайные double по всему диапазону показателей, включая денормализованные
+std::vector<double> GetRandomDoubles(size_t count) {
+    std::mt19937_64 generator(42);
+    std::vector<double> values;
+    while(values.size() < count) {
+        const double value = std::bit_cast<double>(generator());
+        if(std::isfinite(value)) {
+            values.push_back(value);
+        }
+    }
+    return values;
+}
+
+// собирает числа из событий потокового разбора
+class NumbersHandler : public json::Handler {
+public:
+    std::vector<std::variant<int, double>> numbers;
+
+    void Null() override {}
+    void Bool(bool) override {}
+    void Int(int value) override {
+        numbers.push_back(value);
+    }
+    void Double(double value) override {
+        numbers.push_back(value);
+    }
+    void String(std::string) override {}
+    void StartArray() override {}
+    void EndArray() override {}
+    void StartDict() override {}
+    void Key(std::string) override {}
+    void EndDict() override {}
+};
+
+// double -> Writer -> Load: то же значение; целое значение может прочитаться как int
+void TestDoubleRoundTrip() {
+    std::vector<double> values = GetSpecialDoubles();
+    const auto random = GetRandomDoubles(100'000);
+    values.insert(values.end(), random.begin(), random.end());
+    for(double value : values) {
+        const std::string text = PrintValue(value);
+        const json::Node node = ParseValue(text);
+        ASSERT(node.IsDouble());
+        CheckSameDouble(node.AsDouble(), value, text);
+    }
+}
+
+void TestIntRoundTrip() {
+    for(int value : GetSpecialInts()) {
+        const std::string text = PrintValue(value);
+        const json::Node node = ParseValue(text);
+        ASSERT(node.IsInt());
+        ASSERT_EQUAL(node.AsInt(), value);
+    }
+}
+
+// отрицательный ноль сохраняет знак, а не превращается в целый 0
+void TestNegativeZero() {
+    const std::string text = PrintValue(-0.0);
+    ASSERT_EQUAL(text, "-0.0"s);
+    const json::Node node = ParseValue(text);
+    ASSERT(node.IsPureDouble());
+    CheckSameDouble(node.AsDouble(), -0.0, text);
+    ASSERT_EQUAL(PrintValue(0.0), "0"s);
+    // целый -0 остаётся целым нулём
+    ASSERT(ParseValue("-0"sv).IsInt());
+}
+
+// каноническая запись числа -> Load -> Writer: та же запись
+void TestTextRoundTrip() {
+    const std::vector<std::string> texts = {
+        "0"s, "-1"s, "2147483647"s, "-2147483648"s, "2147483648"s, "-2147483649"s, "0.1"s, "-0.0"s,
+        "5e-324"s, "-5e-324"s, "2.2250738585072014e-308"s, "1e+308"s, "1.7976931348623157e+308"s,
+        "123456.789"s, "1e+21"s, "3.14159"s};
+    for(const std::string& text : texts) {
+        ASSERT_EQUAL(PrintValue(ParseValue(text).GetValue()), text);
+    }
+    // числа вне диапазона double и неверные записи - ошибка разбора
+    for(std::string_view text : {"1e309"sv, "-1e400"sv, "1."sv, "-"sv, "1e"sv, "-e1"sv}) {
+        bool thrown = false;
+        try {
+            ParseValue(text);
+        } catch(const json::ParsingError&) {
+            thrown = true;
+        }
+        ASSERT(thrown);
+    }
+}
+
+// число, начинающееся в каждой позиции перед границей блока потокового разбора,
+// читается так же, как из буфера
+void TestNumbersAcrossChunks() {
+    std::vector<std::string> texts;
+    for(double value : GetSpecialDoubles()) {
+        texts.push_back(PrintValue(value));
+    }
+    for(int value : GetSpecialInts()) {
+        texts.push_back(PrintValue(value));
+    }
+    // запись длиннее блока: разорвана дважды
+    texts.push_back("1."s + std::string(2 * STREAM_CHUNK_SIZE, '0') + "5e-1"s);
+
+    for(const std::string& text : texts) {
+        const json::Node expected = ParseValue(text);
+        const size_t max_shift = std::min(text.size(), size_t{32});
+        for(size_t shift = 1; shift <= max_shift; ++shift) {
+            // пробелы до границы блока, затем число и ещё одно число после него
+            std::string document = "["s;
+            document.append(STREAM_CHUNK_SIZE - 1 - shift, ' ').append(text).append(", 7]"sv);
+            std::istringstream input(document);
+            NumbersHandler handler;
+            json::Parse(input, handler);
+            ASSERT_EQUAL(handler.numbers.size(), 2u);
+            if(expected.IsInt()) {
+                ASSERT(std::holds_alternative<int>(handler.numbers[0]));
+                ASSERT_EQUAL(std::get<int>(handler.numbers[0]), expected.AsInt());
+            } else {
+                ASSERT(std::holds_alternative<double>(handler.numbers[0]));
+                CheckSameDouble(std::get<double>(handler.numbers[0]), expected.AsDouble(), text);
+            }
+            ASSERT(handler.numbers[1] == (std::variant<int, double>{7}));
+        }
+    }
+}
+
+}  // namespace
+
+int main() {
+    bool ok = true;
+    ok &= RUN_TEST(TestDoubleRoundTrip);
+    ok &= RUN_TEST(TestIntRoundTrip);
+    ok &= RUN_TEST(TestNegativeZero);
+    ok &= RUN_TEST(TestTextRoundTrip);
+    ok &= RUN_TEST(TestNumbersAcrossChunks);
+    return ok ? 0 : 1;
+}
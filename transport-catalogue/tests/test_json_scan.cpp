@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "json_scan.h"
+#include "testing.h"
+
+using namespace json::scan;
+using namespace std::literals;
+
+namespace {
+
+// Векторные ядра поиска сравниваются со скалярным: каждый байт ставится в каждую позицию
+// буферов длиной до трёх блоков AVX2, так что проверяются все смещения внутри блоков 16 и 32 байт,
+// граница блока и остаток, обрабатываемый по байту. Начало буфера сдвигается, чтобы загрузки
+// были и выровненными, и невыровненными
+
+const size_t MAX_LENGTH = 3 * 32 + 3;
+const size_t MAX_SHIFT = 32;
+
+using FindFunc = const char* (*)(const char*, const char*, Kernel);
+
+struct Search {
+    const char* name;
+    FindFunc func;
+};
+
+const std::vector<Search> SEARCHES = {
+    {"FindStringSpecial", FindStringSpecial},
+    {"SkipSpaces", SkipSpaces},
+    {"FindEscaped", FindEscaped},
+};
+
+// заполнители: обычный символ, пробел и табуляция, чтобы искомый байт был один и для SkipSpaces
+const std::vector<char> FILLERS = {'a', ' ', '\t'};
+
+std::vector<Kernel> GetSupportedKernels() {
+    std::vector<Kernel> kernels;
+    for(Kernel kernel : {Kernel::AUTO, Kernel::SSE2, Kernel::AVX2}) {
+        if(IsSupported(kernel)) {
+            kernels.push_back(kernel);
+        }
+    }
+    return kernels;
+}
+
+// сравнивает результат всех ядер со скалярным на участке [begin, end)
+void CheckKernels(const Search& search, const char* begin, const char* end) {
+    const char* expected = search.func(begin, end, Kernel::SCALAR);
+    for(Kernel kernel : GetSupportedKernels()) {
+        const char* found = search.func(begin, end, kernel);
+        if(found != expected) {
+            throw testing::AssertionError(std::string(search.name) + ": kernel "s
+                                          + std::to_string(static_cast<int>(kernel)) + " found "s
+                                          + std::to_string(found - begin) + " instead of "s
+                                          + std::to_string(expected - begin) + " in "s
+                                          + std::to_string(end - begin) + " bytes"s);
+        }
+    }
+}
+
+// каждый из 256 байт в каждой позиции на фоне каждого заполнителя
+void TestEveryByteAtEveryOffset() {
+    std::string buffer(MAX_SHIFT + MAX_LENGTH, '\0');
+    for(const Search& search : SEARCHES) {
+        for(char filler : FILLERS) {
+            for(size_t length = 0; length <= MAX_LENGTH; ++length) {
+                const size_t shift = length % MAX_SHIFT;
+                char* begin = buffer.data() + shift;
+                std::fill(begin, begin + length, filler);
+                CheckKernels(search, begin, begin + length);
+                for(size_t pos = 0; pos < length; ++pos) {
+                    for(int byte = 0; byte < 256; ++byte) {
+                        begin[pos] = static_cast<char>(byte);
+                        CheckKernels(search, begin, begin + length);
+                    }
+                    begin[pos] = filler;
+                }
+            }
+        }
+    }
+}
+
+// из двух искомых символов в одном блоке находится первый, в том числе через границу блока
+void TestFirstOfTwo() {
+    const std::vector<char> specials = {'"', '\\', '\n', '\r', '\t', '\0', '\x1f', '\x80', 'x'};
+    std::string buffer(MAX_SHIFT + MAX_LENGTH, 'a');
+    for(const Search& search : SEARCHES) {
+        for(char filler : FILLERS) {
+            for(size_t shift = 0; shift < MAX_SHIFT; ++shift) {
+                char* begin = buffer.data() + shift;
+                char* end = begin + 2 * 32 + 1;
+                for(size_t first = 0; first < 40; ++first) {
+                    for(size_t second : {first + 1, first + 15, first + 16, first + 31, first + 32}) {
+                        if(second >= static_cast<size_t>(end - begin)) {
+                            continue;
+                        }
+                        for(char special : specials) {
+                            std::fill(begin, end, filler);
+                            begin[first] = special;
+                            begin[second] = special == '"' ? '\\' : '"';
+                            CheckKernels(search, begin, end);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// ответы на характерных строках, не зависящие от ядра
+void TestKnownAnswers() {
+    const std::string text = "  \t\r\n{\"key\": \"va\\\"lue\"}"s;
+    const char* begin = text.data();
+    const char* end = begin + text.size();
+    for(Kernel kernel : {Kernel::SCALAR, Kernel::AUTO, Kernel::SSE2, Kernel::AVX2}) {
+        ASSERT_EQUAL(SkipSpaces(begin, end, kernel) - begin, 5);
+        ASSERT_EQUAL(FindStringSpecial(begin, end, kernel) - begin, 3);
+        ASSERT_EQUAL(FindEscaped(begin, end, kernel) - begin, 2);
+        ASSERT_EQUAL(FindStringSpecial(begin + 7, end, kernel) - begin, 10);
+        ASSERT(FindEscaped(begin + 7, begin + 10, kernel) == begin + 10);
+        ASSERT(SkipSpaces(begin, begin, kernel) == begin);
+    }
+}
+
+}  // namespace
+
+int main() {
+    bool ok = true;
+    ok &= RUN_TEST(TestEveryByteAtEveryOffset);
+    ok &= RUN_TEST(TestFirstOfTwo);
+    ok &= RUN_TEST(TestKnownAnswers);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,280 @@
+#include <algorithm>
+#include <map>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "transport_catalogue.h"
+#include "testing.h"
+
+using namespace catalogue;
+using namespace std::literals;
+
+namespace {
+
+// Изменение справочника до заморозки: после случайной последовательности UpdateDistance,
+// RemoveBus и ReplaceBus состояние справочника должно совпадать со справочником, заново
+// построенным по итоговым данным. Сравнение идёт по названиям, потому что RemoveBus
+// переносит последний маршрут на место удалённого и id маршрутов расходятся
+
+const size_t STOPS_COUNT = 30;
+const size_t BUSES_COUNT = 12;
+const size_t OPERATIONS_COUNT = 300;
+
+struct BusModel {
+    std::vector<std::string> stops;
+    bool is_roundtrip;
+};
+
+// итоговые данные справочника: по ним строится эталон
+struct NetworkModel {
+    std::vector<std::string> stops;
+    std::vector<geo::Coordinates> coords;
+    std::map<std::pair<std::string, std::string>, size_t> distances;
+    std::map<std::string, BusModel> buses;
+};
+
+std::vector<std::string> MakeRouteStops(const NetworkModel& model, std::mt19937& generator) {
+    std::uniform_int_distribution<size_t> length(2, 8);
+    std::uniform_int_distribution<size_t> stop(0, model.stops.size() - 1);
+    std::vector<std::string> stops(length(generator));
+    for(auto& name : stops) {
+        name = model.stops[stop(generator)];
+    }
+    return stops;
+}
+
+// задаёт расстояния для всех отрезков маршрута, у которых их ещё нет; возвращает добавленные
+std::vector<DistanceDescription> AddMissingDistances(NetworkModel& model, const BusModel& bus,
+                                                     std::mt19937& generator) {
+    std::uniform_int_distribution<size_t> distance(100, 5000);
+    std::vector<DistanceDescription> added;
+    auto add = [&](const std::string& from, const std::string& to) {
+        auto [iter, inserted] = model.distances.try_emplace({from, to}, distance(generator));
+        if(inserted) {
+            added.push_back({iter->first.first, iter->first.second, iter->second});
+        }
+    };
+    for(size_t i = 1; i < bus.stops.size(); ++i) {
+        add(bus.stops[i - 1], bus.stops[i]);
+        if(!bus.is_roundtrip) {
+            add(bus.stops[i], bus.stops[i - 1]);
+        }
+    }
+    return added;
+}
+
+NetworkModel MakeModel(std::mt19937& generator) {
+    NetworkModel model;
+    std::uniform_real_distribution<double> lat(55.5, 55.9);
+    std::uniform_real_distribution<double> lng(37.3, 37.9);
+    for(size_t i = 0; i < STOPS_COUNT; ++i) {
+        model.stops.push_back("Stop "s + std::to_string(i));
+        model.coords.push_back({lat(generator), lng(generator)});
+    }
+    for(size_t i = 0; i < BUSES_COUNT; ++i) {
+        BusModel bus{MakeRouteStops(model, generator), i % 2 == 0};
+        AddMissingDistances(model, bus, generator);
+        model.buses.emplace("Bus "s + std::to_string(i), std::move(bus));
+    }
+    return model;
+}
+
+std::vector<StopId> GetStopIds(const TransportCatalogue& catalogue, const BusModel& bus) {
+    std::vector<StopId> stops;
+    for(const auto& stop : bus.stops) {
+        stops.push_back(catalogue.GetStop(stop)->id);
+    }
+    return stops;
+}
+
+void AddBus(TransportCatalogue& catalogue, std::string_view name, const BusModel& bus) {
+    catalogue.AddBus(Bus{name, GetStopIds(catalogue, bus), bus.is_roundtrip});
+}
+
+void Fill(TransportCatalogue& catalogue, const NetworkModel& model) {
+    for(size_t i = 0; i < model.stops.size(); ++i) {
+        catalogue.AddStop(Stop{model.stops[i], model.coords[i]});
+    }
+    for(const auto& [stops, distance] : model.distances) {
+        catalogue.AddDistanceBetweenStops(stops.first, stops.second, distance);
+    }
+    for(const auto& [name, bus] : model.buses) {
+        AddBus(catalogue, name, bus);
+    }
+}
+
+std::optional<size_t> FindDistance(const TransportCatalogue& catalogue, StopId from, StopId to) {
+    try {
+        return catalogue.GetDistanceBetweenStops(from, to);
+    } catch(const std::out_of_range&) {
+        return std::nullopt;
+    }
+}
+
+std::vector<std::string_view> GetStopBuses(const TransportCatalogue& catalogue, StopId stop) {
+    const auto buses = catalogue.GetStopInfo(stop);
+    return {buses.begin(), buses.end()};
+}
+
+// сравнивает изменённый справочник с эталоном, построенным по модели
+void CheckSameAs(const TransportCatalogue& catalogue, const TransportCatalogue& expected,
+                 const NetworkModel& model) {
+    ASSERT_EQUAL(catalogue.GetStopsCount(), expected.GetStopsCount());
+    ASSERT_EQUAL(catalogue.GetBusesCount(), model.buses.size());
+    ASSERT_EQUAL(catalogue.GetAllRoutes().size(), model.buses.size());
+
+    // id маршрутов плотные, поиск по названию и по id согласован
+    for(BusId id = 0; id < catalogue.GetBusesCount(); ++id) {
+        const Bus* bus = catalogue.GetBusById(id);
+        ASSERT_EQUAL(bus->id, id);
+        ASSERT(catalogue.GetBus(bus->name) == bus);
+        ASSERT(model.buses.count(std::string(bus->name)));
+    }
+    for(const auto& [name, bus_model] : model.buses) {
+        const Bus* bus = catalogue.GetBus(name);
+        const Bus* expected_bus = expected.GetBus(name);
+        ASSERT(bus != nullptr);
+        ASSERT_EQUAL(bus->is_roundtrip, expected_bus->is_roundtrip);
+        ASSERT(std::ranges::equal(bus->stops, expected_bus->stops));
+
+        const BusStats& stats = catalogue.GetRouteInfo(bus);
+        const BusStats& expected_stats = expected.GetRouteInfo(expected_bus);
+        ASSERT_EQUAL(stats.stops_num, expected_stats.stops_num);
+        ASSERT_EQUAL(stats.unique_stops, expected_stats.unique_stops);
+        ASSERT_EQUAL(stats.length_f, expected_stats.length_f);
+        ASSERT_EQUAL(stats.curvature, expected_stats.curvature);
+    }
+
+    for(StopId stop = 0; stop < catalogue.GetStopsCount(); ++stop) {
+        ASSERT_EQUAL(catalogue.GetStopById(stop)->name, expected.GetStopById(stop)->name);
+        ASSERT(GetStopBuses(catalogue, stop) == GetStopBuses(expected, stop));
+        for(StopId to = 0; to < catalogue.GetStopsCount(); ++to) {
+            ASSERT(FindDistance(catalogue, stop, to) == FindDistance(expected, stop, to));
+        }
+    }
+}
+
+// применяет к справочнику и модели случайную последовательность изменений
+// и сравнивает результат с эталоном до и после заморозки
+void CheckRandomMutations(StatsMode stats_mode, unsigned seed) {
+    std::mt19937 generator(seed);
+    NetworkModel model = MakeModel(generator);
+    TransportCatalogue catalogue(stats_mode);
+    Fill(catalogue, model);
+
+    std::uniform_int_distribution<int> operation(0, 9);
+    std::uniform_int_distribution<size_t> distance(100, 5000);
+    size_t next_bus = BUSES_COUNT;
+    for(size_t step = 0; step < OPERATIONS_COUNT; ++step) {
+        // в ленивом режиме статистика части маршрутов уже рассчитана и должна пересчитываться
+        if(!model.buses.empty() && step % 3 == 0) {
+            auto bus = std::next(model.buses.begin(), generator() % model.buses.size());
+            catalogue.GetRouteInfo(catalogue.GetBus(bus->first));
+        }
+
+        const int kind = operation(generator);
+        if(kind < 4) {
+            // расстояние на отрезке существующего маршрута, если он есть, иначе между любыми остановками
+            std::pair<std::string, std::string> stops{model.stops[generator() % model.stops.size()],
+                                                      model.stops[generator() % model.stops.size()]};
+            if(!model.buses.empty() && kind < 3) {
+                const auto& bus = std::next(model.buses.begin(), generator() % model.buses.size())->second;
+                const size_t i = 1 + generator() % (bus.stops.size() - 1);
+                stops = kind == 0 ? std::pair{bus.stops[i], bus.stops[i - 1]} : std::pair{bus.stops[i - 1], bus.stops[i]};
+            }
+            const size_t value = distance(generator);
+            model.distances[stops] = value;
+            catalogue.UpdateDistance(stops.first, stops.second, value);
+        } else if(kind < 6 && !model.buses.empty()) {
+            auto bus = std::next(model.buses.begin(), generator() % model.buses.size());
+            catalogue.RemoveBus(bus->first);
+            model.buses.erase(bus);
+        } else if(kind < 8 && !model.buses.empty()) {
+            auto bus = std::next(model.buses.begin(), generator() % model.buses.size());
+            BusModel replacement{MakeRouteStops(model, generator), generator() % 2 == 0};
+            catalogue.UpdateDistances(AddMissingDistances(model, replacement, generator));
+            catalogue.ReplaceBus(Bus{bus->first, GetStopIds(catalogue, replacement), replacement.is_roundtrip});
+            bus->second = std::move(replacement);
+        } else {
+            // новый маршрут получает последний id, и следующий RemoveBus может перенести его
+            BusModel bus{MakeRouteStops(model, generator), generator() % 2 == 0};
+            catalogue.UpdateDistances(AddMissingDistances(model, bus, generator));
+            auto iter = model.buses.emplace("Bus "s + std::to_string(next_bus++), std::move(bus)).first;
+            AddBus(catalogue, iter->first, iter->second);
+        }
+    }
+
+    TransportCatalogue expected(stats_mode);
+    Fill(expected, model);
+    CheckSameAs(catalogue, expected, model);
+
+    catalogue.Freeze();
+    expected.Freeze();
+    CheckSameAs(catalogue, expected, model);
+}
+
+}  // namespace
+
+void TestEagerMutations() {
+    for(unsigned seed = 1; seed <= 20; ++seed) {
+        CheckRandomMutations(StatsMode::EAGER, seed);
+    }
+}
+
+void TestLazyMutations() {
+    for(unsigned seed = 1; seed <= 20; ++seed) {
+        CheckRandomMutations(StatsMode::LAZY, seed);
+    }
+}
+
+// удаление единственного и последнего маршрута, замена маршрута его же остановками
+void TestEdgeCases() {
+    for(StatsMode stats_mode : {StatsMode::EAGER, StatsMode::LAZY}) {
+        std::mt19937 generator(0);
+        NetworkModel model = MakeModel(generator);
+        TransportCatalogue catalogue(stats_mode);
+        Fill(catalogue, model);
+
+        const Bus* last = catalogue.GetBusById(static_cast<BusId>(catalogue.GetBusesCount() - 1));
+        const std::string last_name(last->name);
+        catalogue.GetRouteInfo(last);
+        catalogue.RemoveBus(last_name);
+        model.buses.erase(last_name);
+
+        const Bus* bus = catalogue.GetBusById(0);
+        catalogue.ReplaceBus(*bus);
+
+        bool thrown = false;
+        try {
+            catalogue.RemoveBus(last_name);
+        } catch(const std::out_of_range&) {
+            thrown = true;
+        }
+        ASSERT(thrown);
+
+        TransportCatalogue expected(stats_mode);
+        Fill(expected, model);
+        CheckSameAs(catalogue, expected, model);
+
+        while(!model.buses.empty()) {
+            catalogue.RemoveBus(model.buses.begin()->first);
+            model.buses.erase(model.buses.begin());
+        }
+        TransportCatalogue empty(stats_mode);
+        Fill(empty, model);
+        CheckSameAs(catalogue, empty, model);
+    }
+}
+
+int main() {
+    bool ok = true;
+    ok &= RUN_TEST(TestEagerMutations);
+    ok &= RUN_TEST(TestLazyMutations);
+    ok &= RUN_TEST(TestEdgeCases);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,209 @@
+#include <algorithm>
+#include <random>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "transport_catalogue.h"
+#include "testing.h"
+
+using namespace catalogue;
+using namespace std::literals;
+
+namespace {
+
+// Поиск остановок по началу названия: SearchStops замороженного справочника совпадает с перебором.
+// Расстояние до названия - наименьшее расстояние Левенштейна от запроса до префиксов названия,
+// считаемое по символам Unicode, а не по байтам UTF-8; ответ упорядочен по расстоянию, затем по названию.
+// Названия собраны из слов с общими началами, в них есть символы из 1, 2, 3 и 4 байт
+
+const size_t STOPS_COUNT = 600;
+const size_t QUERIES_COUNT = 400;
+
+const std::vector<std::string_view> WORDS = {
+    "Улица"sv, "Улитка"sv, "Ул"sv, "Парк"sv, "Парковая"sv, "Пар"sv, "Лесная"sv, "Лес"sv, "ёлка"sv, "Ёлки"sv,
+    "Lenin"sv, "Len"sv, "Park"sv, "1"sv, "2-я"sv, "€"sv, "𝄞"sv, "Площадь"sv, "Пл."sv, "日本"sv};
+
+// раскладывает строку UTF-8 на символы; строки теста - корректный UTF-8
+std::vector<char32_t> Decode(std::string_view str) {
+    std::vector<char32_t> symbols;
+    for(size_t pos = 0; pos < str.size();) {
+        const auto lead = static_cast<unsigned char>(str[pos]);
+        const size_t length = lead < 0x80 ? 1 : lead < 0xE0 ? 2 : lead < 0xF0 ? 3 : 4;
+        char32_t code = length == 1 ? lead : length == 2 ? lead & 0x1F : length == 3 ? lead & 0x0F : lead & 0x07;
+        for(size_t i = 1; i < length; ++i) {
+            code = (code << 6) | (static_cast<unsigned char>(str[pos + i]) & 0x3F);
+        }
+        symbols.push_back(code);
+        pos += length;
+    }
+    return symbols;
+}
+
+std::string Encode(const std::vector<char32_t>& symbols) {
+    std::string str;
+    for(char32_t code : symbols) {
+        if(code < 0x80) {
+            str += static_cast<char>(code);
+        } else if(code < 0x800) {
+            str += static_cast<char>(0xC0 | (code >> 6));
+            str += static_cast<char>(0x80 | (code & 0x3F));
+        } else if(code < 0x10000) {
+            str += static_cast<char>(0xE0 | (code >> 12));
+            str += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            str += static_cast<char>(0x80 | (code & 0x3F));
+        } else {
+            str += static_cast<char>(0xF0 | (code >> 18));
+            str += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            str += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            str += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+    return str;
+}
+
+// наименьшее расстояние Левенштейна от query до префиксов name
+size_t PrefixDistance(const std::vector<char32_t>& query, const std::vector<char32_t>& name) {
+    std::vector<size_t> row(query.size() + 1);
+    for(size_t j = 0; j <= query.size(); ++j) {
+        row[j] = j;
+    }
+    size_t best = row.back();
+    for(char32_t symbol : name) {
+        size_t diagonal = row[0];
+        ++row[0];
+        for(size_t j = 1; j <= query.size(); ++j) {
+            const size_t above = row[j];
+            row[j] = std::min({above + 1, row[j - 1] + 1, diagonal + (query[j - 1] == symbol ? 0 : 1)});
+            diagonal = above;
+        }
+        best = std::min(best, row.back());
+    }
+    return best;
+}
+
+std::vector<std::string> MakeNames(std::mt19937& generator) {
+    std::uniform_int_distribution<size_t> words_count(1, 3);
+    std::set<std::string> names;
+    while(names.size() < STOPS_COUNT) {
+        std::string name(WORDS[generator() % WORDS.size()]);
+        for(size_t i = words_count(generator); i > 1; --i) {
+            name.append(" "sv).append(WORDS[generator() % WORDS.size()]);
+        }
+        names.insert(std::move(name));
+    }
+    return {names.begin(), names.end()};
+}
+
+// начало случайного названия с несколькими случайными правками или случайная строка из символов названий
+std::string MakeQuery(const std::vector<std::string>& names, std::mt19937& generator) {
+    std::vector<char32_t> symbols = Decode(names[generator() % names.size()]);
+    std::vector<char32_t> alphabet = Decode(names[generator() % names.size()]);
+    alphabet.push_back(U'Я');
+    if(generator() % 10 == 0) {
+        std::shuffle(symbols.begin(), symbols.end(), generator);
+    }
+    symbols.resize(generator() % (symbols.size() + 1));
+    for(size_t edits = generator() % 4; edits > 0; --edits) {
+        const char32_t symbol = alphabet[generator() % alphabet.size()];
+        const size_t kind = generator() % 3;
+        if(kind == 0 || symbols.empty()) {
+            symbols.insert(symbols.begin() + generator() % (symbols.size() + 1), symbol);
+        } else if(kind == 1) {
+            symbols.erase(symbols.begin() + generator() % symbols.size());
+        } else {
+            symbols[generator() % symbols.size()] = symbol;
+        }
+    }
+    return Encode(symbols);
+}
+
+void Fill(TransportCatalogue& catalogue, const std::vector<std::string>& names) {
+    std::vector<Stop> stops;
+    for(size_t i = 0; i < names.size(); ++i) {
+        stops.push_back(Stop{names[i], geo::Coordinates{55.5 + 1e-4 * i, 37.5}});
+    }
+    // остановки добавляются не по алфавиту
+    std::shuffle(stops.begin(), stops.end(), std::mt19937(1));
+    catalogue.AddBulk(stops, {}, {});
+    catalogue.Freeze();
+}
+
+std::vector<std::string_view> Search(const TransportCatalogue& catalogue, std::string_view query,
+                                     size_t max_distance, size_t limit) {
+    std::vector<std::string_view> result;
+    for(const Stop* stop : catalogue.SearchStops(query, max_distance, limit)) {
+        result.push_back(stop->name);
+    }
+    return result;
+}
+
+// ответ перебором: названия на расстоянии не больше max_distance по возрастанию расстояния, затем названия
+std::vector<std::string_view> SearchBruteForce(const std::vector<std::string>& names, std::string_view query,
+                                               size_t max_distance, size_t limit) {
+    const auto pattern = Decode(query);
+    std::vector<std::pair<size_t, std::string_view>> found;
+    for(const std::string& name : names) {
+        const size_t distance = PrefixDistance(pattern, Decode(name));
+        if(distance <= max_distance) {
+            found.emplace_back(distance, name);
+        }
+    }
+    std::sort(found.begin(), found.end());
+    std::vector<std::string_view> result;
+    for(size_t i = 0; i < found.size() && i < limit; ++i) {
+        result.push_back(found[i].second);
+    }
+    return result;
+}
+
+// расстояние считается по символам: замена кириллической буквы (2 байта), символа
+// из 3 или 4 байт - одна правка
+void TestUtf8Distance() {
+    const std::vector<std::string> names = {"Улица Ленина"s, "Улитка"s, "€ 5"s, "𝄞 Ноты"s, "日本橋"s};
+    TransportCatalogue catalogue;
+    Fill(catalogue, names);
+    ASSERT(Search(catalogue, "Улица"sv, 0, 10) == (std::vector{"Улица Ленина"sv}));
+    // до префикса "Улит" две правки: замена и удаление
+    ASSERT(Search(catalogue, "Улица"sv, 1, 10) == (std::vector{"Улица Ленина"sv}));
+    ASSERT(Search(catalogue, "Улица"sv, 2, 10) == (std::vector{"Улица Ленина"sv, "Улитка"sv}));
+    ASSERT(Search(catalogue, "Ули"sv, 0, 10) == (std::vector{"Улитка"sv, "Улица Ленина"sv}));
+    ASSERT(Search(catalogue, "Улжца Ленина"sv, 1, 10) == (std::vector{"Улица Ленина"sv}));
+    ASSERT(Search(catalogue, "$ 5"sv, 1, 10) == (std::vector{"€ 5"sv}));
+    ASSERT(Search(catalogue, "♪ Ноты"sv, 1, 10) == (std::vector{"𝄞 Ноты"sv}));
+    ASSERT(Search(catalogue, "Ноты"sv, 1, 10).empty());
+    ASSERT(Search(catalogue, "Ноты"sv, 2, 10) == (std::vector{"𝄞 Ноты"sv}));
+    ASSERT(Search(catalogue, "日本"sv, 0, 10) == (std::vector{"日本橋"sv}));
+    ASSERT(Search(catalogue, "日文"sv, 1, 10) == (std::vector{"日本橋"sv}));
+    // при равном расстоянии - по названию
+    ASSERT(Search(catalogue, "Ул"sv, 0, 1) == (std::vector{"Улитка"sv}));
+}
+
+void TestRandomSearch() {
+    std::mt19937 generator(42);
+    const auto names = MakeNames(generator);
+    TransportCatalogue catalogue;
+    Fill(catalogue, names);
+
+    std::uniform_int_distribution<size_t> max_distance(0, 3);
+    const std::vector<size_t> limits = {1, 3, 10, 50, STOPS_COUNT};
+    for(size_t i = 0; i < QUERIES_COUNT; ++i) {
+        const std::string query = MakeQuery(names, generator);
+        const size_t distance = max_distance(generator);
+        const size_t limit = limits[generator() % limits.size()];
+        ASSERT(Search(catalogue, query, distance, limit) == SearchBruteForce(names, query, distance, limit));
+    }
+    // пустой запрос - все названия по алфавиту
+    ASSERT(Search(catalogue, ""sv, 0, STOPS_COUNT) == SearchBruteForce(names, ""sv, 0, STOPS_COUNT));
+    ASSERT(Search(catalogue, "Улица"sv, 2, 0).empty());
+}
+
+}  // namespace
+
+int main() {
+    bool ok = true;
+    ok &= RUN_TEST(TestUtf8Distance);
+    ok &= RUN_TEST(TestRandomSearch);
+    return ok ? 0 : 1;
+}
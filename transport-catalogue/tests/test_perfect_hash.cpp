@@ -0,0 +1,102 @@
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "perfect_hash.h"
+#include "transport_catalogue.h"
+#include "testing.h"
+
+using namespace catalogue;
+using namespace std::literals;
+
+namespace {
+
+std::vector<std::string> MakeNames(size_t count, std::string_view prefix) {
+    std::vector<std::string> names;
+    names.reserve(count);
+    for(size_t i = 0; i < count; ++i) {
+        names.push_back(std::string(prefix) + std::to_string(i * 7919));
+    }
+    return names;
+}
+
+// каждый ключ получает свою ячейку из [0, size)
+void CheckBijection(size_t count) {
+    const auto names = MakeNames(count, "Остановка "sv);
+    const std::vector<std::string_view> keys(names.begin(), names.end());
+    const PerfectHashFunction function(keys);
+    ASSERT_EQUAL(function.GetSize(), count);
+
+    std::vector<bool> used(count);
+    for(std::string_view key : keys) {
+        const size_t slot = function(key);
+        ASSERT(slot < count);
+        ASSERT(!used[slot]);
+        used[slot] = true;
+    }
+}
+
+void TestSmallSets() {
+    for(size_t count : {1, 2, 3, 5, 17, 100, 1000}) {
+        CheckBijection(count);
+    }
+}
+
+// большой набор строится без исключения при запасе таблицы размещения
+void TestLargeSet() {
+    CheckBijection(1'000'000);
+}
+
+// после заморозки справочник ищет названия по совершенной хеш-функции и ячейкам by_slot:
+// каждое название находит свою запись, чужое название не находит ничего
+void TestCatalogueFind() {
+    const auto stop_names = MakeNames(10'000, "Остановка "sv);
+    const auto bus_names = MakeNames(1'000, "Bus "sv);
+    std::vector<Stop> stops;
+    for(size_t i = 0; i < stop_names.size(); ++i) {
+        stops.push_back(Stop{stop_names[i], geo::Coordinates{55.5 + 1e-5 * i, 37.5}});
+    }
+    std::vector<BusDescription> buses;
+    for(size_t i = 0; i < bus_names.size(); ++i) {
+        buses.push_back({bus_names[i], {stop_names[i], stop_names[i + 1]}, false});
+    }
+    TransportCatalogue catalogue;
+    catalogue.AddBulk(stops, {}, buses);
+    catalogue.Freeze();
+
+    const FrozenIndexes indexes = catalogue.GetFrozenIndexes();
+    ASSERT_EQUAL(indexes.stops_hash.size, stop_names.size());
+    ASSERT_EQUAL(indexes.stops_by_slot.size(), stop_names.size());
+    ASSERT_EQUAL(indexes.buses_hash.size, bus_names.size());
+    ASSERT_EQUAL(indexes.buses_by_slot.size(), bus_names.size());
+    for(StopId id = 0; id < stop_names.size(); ++id) {
+        const Stop* stop = catalogue.GetStop(stop_names[id]);
+        ASSERT(stop == catalogue.GetStopById(id));
+    }
+    for(BusId id = 0; id < bus_names.size(); ++id) {
+        const Bus* bus = catalogue.GetBus(bus_names[id]);
+        ASSERT(bus == catalogue.GetBusById(id));
+    }
+    for(std::string_view name : {""sv, "Остановка"sv, "Остановка 1"sv, "Bus"sv, "Bus 1"sv}) {
+        ASSERT(catalogue.GetStop(name) == nullptr);
+        ASSERT(catalogue.GetBus(name) == nullptr);
+    }
+    // названия маршрутов не находятся среди остановок и наоборот
+    ASSERT(catalogue.GetStop(bus_names[0]) == nullptr);
+    ASSERT(catalogue.GetBus(stop_names[0]) == nullptr);
+
+    TransportCatalogue empty;
+    empty.Freeze();
+    ASSERT(empty.GetStop(stop_names[0]) == nullptr);
+    ASSERT(empty.GetBus(bus_names[0]) == nullptr);
+}
+
+}  // namespace
+
+int main() {
+    bool ok = true;
+    ok &= RUN_TEST(TestSmallSets);
+    ok &= RUN_TEST(TestLargeSet);
+    ok &= RUN_TEST(TestCatalogueFind);
+    return ok ? 0 : 1;
+}
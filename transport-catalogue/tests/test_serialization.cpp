@@ -0,0 +1,155 @@
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "serialization.h"
+#include "transport_catalogue.h"
+#include "testing.h"
+
+using namespace catalogue;
+using namespace std::literals;
+
+namespace {
+
+// Снимок справочника: сохранённый и загруженный справочник отвечает так же, как исходный,
+// а повреждённый снимок отвергается при загрузке, а не при обращении к данным
+
+const size_t STOPS_COUNT = 10;
+
+void Fill(TransportCatalogue& catalogue) {
+    std::vector<std::string> names;
+    for(size_t i = 0; i < STOPS_COUNT; ++i) {
+        names.push_back("Stop "s + std::to_string(i));
+    }
+    std::vector<Stop> stops;
+    std::vector<DistanceDescription> distances;
+    for(size_t i = 0; i < STOPS_COUNT; ++i) {
+        stops.push_back(Stop{names[i], geo::Coordinates{55.6 + 0.01 * i, 37.6 - 0.02 * i}});
+        if(i > 0) {
+            distances.push_back({names[i - 1], names[i], 1000 + 100 * i});
+        }
+    }
+    catalogue.AddBulk(stops, distances, {{"Line"sv, {names[0], names[3], names[4], names[5]}, false},
+                                         {"Ring"sv, {names[7], names[8], names[9], names[7]}, true}});
+    catalogue.AddDistanceBetweenStops(names[0], names[3], 2500);
+    catalogue.AddDistanceBetweenStops(names[9], names[7], 1800);
+}
+
+serialization::BaseSettings MakeSettings() {
+    serialization::BaseSettings settings;
+    settings.routing_settings = {40, 6};
+    return settings;
+}
+
+std::string SaveToString(const TransportCatalogue& catalogue) {
+    std::ostringstream output;
+    serialization::Save(output, catalogue, MakeSettings());
+    return output.str();
+}
+
+// записывает снимок во временный файл и загружает его в новый справочник
+void LoadFromString(const std::string& snapshot, TransportCatalogue& catalogue) {
+    const auto path = std::filesystem::temp_directory_path() / "test_serialization.db"s;
+    std::ofstream(path, std::ios::binary) << snapshot;
+    try {
+        serialization::Load(path, catalogue);
+    } catch(...) {
+        std::filesystem::remove(path);
+        throw;
+    }
+    std::filesystem::remove(path);
+}
+
+bool LoadThrows(const std::string& snapshot) {
+    TransportCatalogue catalogue;
+    try {
+        LoadFromString(snapshot, catalogue);
+    } catch(const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+// позиция счётчика элементов массива values в снимке: счётчик (uint64), выравнивание нулями
+// до 8 байт, затем сами элементы
+size_t FindArrayCount(const std::string& snapshot, std::span<const uint32_t> values) {
+    const std::string_view bytes{reinterpret_cast<const char*>(values.data()), values.size_bytes()};
+    std::vector<size_t> found;
+    for(size_t pos = snapshot.find(bytes); pos != std::string::npos; pos = snapshot.find(bytes, pos + 1)) {
+        for(size_t padding = 0; padding < 8 && padding + 8 <= pos; ++padding) {
+            uint64_t count;
+            std::memcpy(&count, snapshot.data() + pos - padding - 8, sizeof(count));
+            if(count == values.size() && snapshot.compare(pos - padding, padding, std::string(padding, '\0')) == 0) {
+                found.push_back(pos - padding - 8);
+            }
+        }
+    }
+    ASSERT_EQUAL(found.size(), 1u);
+    return found.front();
+}
+
+void TestRoundTrip() {
+    TransportCatalogue catalogue;
+    Fill(catalogue);
+    catalogue.Freeze();
+
+    TransportCatalogue loaded;
+    LoadFromString(SaveToString(catalogue), loaded);
+    ASSERT_EQUAL(loaded.GetStopsCount(), catalogue.GetStopsCount());
+    ASSERT_EQUAL(loaded.GetBusesCount(), catalogue.GetBusesCount());
+    for(StopId id = 0; id < catalogue.GetStopsCount(); ++id) {
+        const std::string_view name = catalogue.GetStopById(id)->name;
+        ASSERT(loaded.GetStop(name) == loaded.GetStopById(id));
+    }
+    for(BusId id = 0; id < catalogue.GetBusesCount(); ++id) {
+        const Bus* bus = catalogue.GetBusById(id);
+        ASSERT(loaded.GetBus(bus->name) == loaded.GetBusById(id));
+        ASSERT_EQUAL(loaded.GetRouteInfo(id).length_f, catalogue.GetRouteInfo(id).length_f);
+    }
+    ASSERT(loaded.GetStop("Stop 10"sv) == nullptr);
+    ASSERT(loaded.GetBus("Loop"sv) == nullptr);
+}
+
+// ячеек хеш-функции остановок меньше, чем ключей: поиск вышел бы за конец массива
+void TestShortStopsBySlot() {
+    TransportCatalogue catalogue;
+    Fill(catalogue);
+    catalogue.Freeze();
+    const std::string snapshot = SaveToString(catalogue);
+    const size_t count_pos = FindArrayCount(snapshot, catalogue.GetFrozenIndexes().stops_by_slot);
+
+    // два последних элемента (8 байт) убираются, выравнивание следующих массивов не меняется
+    std::string broken = snapshot;
+    const uint64_t short_count = STOPS_COUNT - 2;
+    std::memcpy(broken.data() + count_pos, &short_count, sizeof(short_count));
+    const size_t array_end = snapshot.find(std::string_view{
+        reinterpret_cast<const char*>(catalogue.GetFrozenIndexes().stops_by_slot.data()), STOPS_COUNT * 4})
+        + STOPS_COUNT * 4;
+    broken.erase(array_end - 8, 8);
+    ASSERT(LoadThrows(broken));
+}
+
+void TestTruncatedSnapshot() {
+    TransportCatalogue catalogue;
+    Fill(catalogue);
+    catalogue.Freeze();
+    const std::string snapshot = SaveToString(catalogue);
+    for(size_t size : {size_t{0}, size_t{7}, snapshot.size() / 2, snapshot.size() - 1}) {
+        ASSERT(LoadThrows(snapshot.substr(0, size)));
+    }
+}
+
+}  // namespace
+
+int main() {
+    bool ok = true;
+    ok &= RUN_TEST(TestRoundTrip);
+    ok &= RUN_TEST(TestShortStopsBySlot);
+    ok &= RUN_TEST(TestTruncatedSnapshot);
+    return ok ? 0 : 1;
+}
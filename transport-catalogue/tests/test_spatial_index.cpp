@@ -0,0 +1,220 @@
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "geo.h"
+#include "transport_catalogue.h"
+#include "testing.h"
+
+using namespace catalogue;
+using namespace std::literals;
+
+namespace {
+
+// Пространственный индекс остановок: GetNearestStops и GetStopsInBox замороженного справочника
+// совпадают с полным перебором остановок. Остановки разбросаны по всему шару и сгущаются в городе,
+// у полюсов и у 180-го меридиана; у части остановок одинаковые координаты
+
+const size_t STOPS_COUNT = 2000;
+const size_t QUERIES_COUNT = 300;
+
+// случайная точка, равномерно распределённая по сфере
+geo::Coordinates RandomPoint(std::mt19937& generator) {
+    std::uniform_real_distribution<double> z(-1., 1.);
+    std::uniform_real_distribution<double> lng(-180., 180.);
+    return {std::asin(z(generator)) * 180. / std::numbers::pi, lng(generator)};
+}
+
+// приводит широту к [-90, 90], долготу - к [-180, 180]
+geo::Coordinates Normalize(geo::Coordinates coord) {
+    if(coord.lng > 180.) {
+        coord.lng -= 360.;
+    } else if(coord.lng < -180.) {
+        coord.lng += 360.;
+    }
+    return {std::clamp(coord.lat, -90., 90.), coord.lng};
+}
+
+// точка в окрестности center не дальше spread градусов по каждой оси
+geo::Coordinates RandomPointNear(geo::Coordinates center, double spread, std::mt19937& generator) {
+    std::uniform_real_distribution<double> offset(-spread, spread);
+    return Normalize({center.lat + offset(generator), center.lng + offset(generator)});
+}
+
+std::vector<geo::Coordinates> MakeCoords(std::mt19937& generator) {
+    const std::vector<geo::Coordinates> centers = {{55.75, 37.62}, {89.9, 0.}, {-89.9, 120.}, {10., 180.},
+                                                   {-40., -179.99}};
+    std::vector<geo::Coordinates> coords;
+    while(coords.size() < STOPS_COUNT) {
+        const size_t kind = coords.size() % 4;
+        if(kind == 0) {
+            coords.push_back(RandomPoint(generator));
+        } else if(kind == 1 || kind == 2) {
+            coords.push_back(RandomPointNear(centers[generator() % centers.size()], 0.5, generator));
+        } else {
+            // повтор уже заданных координат
+            coords.push_back(coords[generator() % coords.size()]);
+        }
+    }
+    return coords;
+}
+
+void Fill(TransportCatalogue& catalogue, const std::vector<geo::Coordinates>& coords) {
+    std::vector<std::string> names;
+    for(size_t i = 0; i < coords.size(); ++i) {
+        names.push_back("Остановка "s.append(std::to_string(i)));
+    }
+    std::vector<Stop> stops;
+    for(size_t i = 0; i < coords.size(); ++i) {
+        stops.push_back(Stop{names[i], coords[i]});
+    }
+    catalogue.AddBulk(stops, {}, {});
+    catalogue.Freeze();
+}
+
+// расстояние, по которому индекс сравнивает остановки
+double GetDistance(geo::Coordinates point, const Stop& stop) {
+    return geo::ComputeDistance(geo::ToSpherePoint(point), geo::ToSpherePoint(stop.coord));
+}
+
+// проверяет ответ GetNearestStops перебором; при одинаковых расстояниях остановки могут идти в любом порядке.
+// Возвращает false, если граница radius слишком близка к одной из остановок и ответ неоднозначен
+bool CheckNearest(const TransportCatalogue& catalogue, geo::Coordinates point, size_t count, double radius) {
+    std::vector<double> expected;
+    for(StopId id = 0; id < catalogue.GetStopsCount(); ++id) {
+        const double distance = GetDistance(point, *catalogue.GetStopById(id));
+        if(std::abs(distance - radius) < 1.) {
+            return false;
+        }
+        if(distance <= radius) {
+            expected.push_back(distance);
+        }
+    }
+    std::sort(expected.begin(), expected.end());
+    expected.resize(std::min(expected.size(), count));
+
+    const auto result = catalogue.GetNearestStops(point, count, radius);
+    ASSERT_EQUAL(result.size(), expected.size());
+    std::vector<const Stop*> found;
+    for(size_t i = 0; i < result.size(); ++i) {
+        ASSERT_NEAR(result[i].distance, expected[i], 1e-6);
+        ASSERT_NEAR(result[i].distance, GetDistance(point, *result[i].stop), 1e-6);
+        found.push_back(result[i].stop);
+    }
+    std::sort(found.begin(), found.end());
+    ASSERT(std::adjacent_find(found.begin(), found.end()) == found.end());
+    return true;
+}
+
+void TestNearestStops() {
+    std::mt19937 generator(42);
+    TransportCatalogue catalogue;
+    Fill(catalogue, MakeCoords(generator));
+
+    std::uniform_int_distribution<size_t> count(1, 30);
+    // радиус от сотен метров до половины окружности Земли
+    std::uniform_real_distribution<double> log_radius(std::log(100.), std::log(2e7));
+    size_t checked = 0;
+    for(size_t i = 0; i < QUERIES_COUNT; ++i) {
+        const geo::Coordinates point = i % 2 == 0
+            ? RandomPoint(generator)
+            : geo::Coordinates(catalogue.GetStopById(static_cast<StopId>(generator() % STOPS_COUNT))->coord);
+        checked += CheckNearest(catalogue, point, count(generator), std::exp(log_radius(generator)));
+    }
+    ASSERT(checked > QUERIES_COUNT * 9 / 10);
+
+    // все остановки, нулевое число и нулевой радиус
+    ASSERT(CheckNearest(catalogue, {0.3, 0.7}, STOPS_COUNT + 10, 3e7));
+    ASSERT(catalogue.GetNearestStops({55.75, 37.62}, 0, 1e6).empty());
+    // при нулевом радиусе находятся все остановки в той же точке (и не дальше погрешности сравнения)
+    const Stop* stop = catalogue.GetStopById(3);
+    const auto same_point = catalogue.GetNearestStops(stop->coord, STOPS_COUNT, 0.);
+    for(const NearbyStop& nearby : same_point) {
+        ASSERT(nearby.distance < 10.);
+    }
+    size_t expected_count = 0;
+    for(StopId id = 0; id < catalogue.GetStopsCount(); ++id) {
+        expected_count += catalogue.GetStopById(id)->coord == stop->coord;
+    }
+    const auto same_count = std::count_if(same_point.begin(), same_point.end(), [stop](const NearbyStop& nearby) {
+        return nearby.stop->coord == stop->coord;
+    });
+    // остановка 3 повторяет координаты одной из предыдущих
+    ASSERT(expected_count > 1);
+    ASSERT_EQUAL(static_cast<size_t>(same_count), expected_count);
+}
+
+bool IsInside(geo::Coordinates coord, geo::Coordinates min, geo::Coordinates max) {
+    const bool lat_inside = min.lat <= coord.lat && coord.lat <= max.lat;
+    if(min.lng <= max.lng) {
+        return lat_inside && min.lng <= coord.lng && coord.lng <= max.lng;
+    }
+    return lat_inside && (min.lng <= coord.lng || coord.lng <= max.lng);
+}
+
+void CheckBox(const TransportCatalogue& catalogue, geo::Coordinates min, geo::Coordinates max) {
+    std::vector<const Stop*> expected;
+    for(StopId id = 0; id < catalogue.GetStopsCount(); ++id) {
+        const Stop* stop = catalogue.GetStopById(id);
+        if(min.lat <= max.lat && IsInside(stop->coord, min, max)) {
+            expected.push_back(stop);
+        }
+    }
+    std::sort(expected.begin(), expected.end(), [](const Stop* lhs, const Stop* rhs) {
+        return lhs->name < rhs->name;
+    });
+    ASSERT(catalogue.GetStopsInBox(min, max) == expected);
+}
+
+void TestStopsInBox() {
+    std::mt19937 generator(7);
+    TransportCatalogue catalogue;
+    Fill(catalogue, MakeCoords(generator));
+
+    std::uniform_real_distribution<double> lat(-90., 90.);
+    std::uniform_real_distribution<double> lng(-180., 180.);
+    std::uniform_real_distribution<double> size(0.01, 2.);
+    for(size_t i = 0; i < QUERIES_COUNT; ++i) {
+        geo::Coordinates min;
+        geo::Coordinates max;
+        if(i % 3 == 0) {
+            // произвольный прямоугольник, в том числе через 180-й меридиан (min.lng > max.lng)
+            min = {lat(generator), lng(generator)};
+            max = {lat(generator), lng(generator)};
+            if(min.lat > max.lat) {
+                std::swap(min.lat, max.lat);
+            }
+        } else if(i % 3 == 1) {
+            // небольшой прямоугольник вокруг остановки, долгота может выйти за 180
+            const geo::Coordinates center = catalogue.GetStopById(static_cast<StopId>(generator() % STOPS_COUNT))->coord;
+            const double half = size(generator);
+            min = Normalize({center.lat - half, center.lng - half});
+            max = Normalize({center.lat + half, center.lng + half});
+        } else {
+            // границы проходят точно через остановки
+            const geo::Coordinates first = catalogue.GetStopById(static_cast<StopId>(generator() % STOPS_COUNT))->coord;
+            const geo::Coordinates second = catalogue.GetStopById(static_cast<StopId>(generator() % STOPS_COUNT))->coord;
+            min = {std::min(first.lat, second.lat), first.lng};
+            max = {std::max(first.lat, second.lat), second.lng};
+        }
+        CheckBox(catalogue, min, max);
+    }
+
+    // весь шар, полярные шапки, пустой прямоугольник
+    CheckBox(catalogue, {-90., -180.}, {90., 180.});
+    CheckBox(catalogue, {89., -180.}, {90., 180.});
+    CheckBox(catalogue, {-90., 170.}, {-89., -170.});
+    CheckBox(catalogue, {10., 10.}, {-10., 20.});
+}
+
+}  // namespace
+
+int main() {
+    bool ok = true;
+    ok &= RUN_TEST(TestNearestStops);
+    ok &= RUN_TEST(TestStopsInBox);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+// Минимальные проверки для тестов: при ошибке выбрасывают исключение с местом и значениями,
+// RUN_TEST печатает результат теста и возвращает false при ошибке
+
+namespace testing {
+
+class AssertionError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+template <typename Lhs, typename Rhs>
+void AssertEqual(const Lhs& lhs, const Rhs& rhs, const char* lhs_str, const char* rhs_str,
+                 const char* file, int line) {
+    if(!(lhs == rhs)) {
+        std::ostringstream message;
+        message << file << ':' << line << ": ASSERT_EQUAL(" << lhs_str << ", " << rhs_str
+                << ") failed: " << lhs << " != " << rhs;
+        throw AssertionError(message.str());
+    }
+}
+
+inline void AssertNear(double lhs, double rhs, double tolerance, const char* lhs_str, const char* rhs_str,
+                       const char* file, int line) {
+    if(!(std::abs(lhs - rhs) <= tolerance)) {
+        std::ostringstream message;
+        message.precision(17);
+        message << file << ':' << line << ": ASSERT_NEAR(" << lhs_str << ", " << rhs_str
+                << ") failed: " << lhs << " vs " << rhs << ", tolerance " << tolerance;
+        throw AssertionError(message.str());
+    }
+}
+
+inline void Assert(bool value, const char* expr_str, const char* file, int line) {
+    if(!value) {
+        std::ostringstream message;
+        message << file << ':' << line << ": ASSERT(" << expr_str << ") failed";
+        throw AssertionError(message.str());
+    }
+}
+
+template <typename Func>
+bool RunTest(Func func, const char* name) {
+    try {
+        func();
+        std::cerr << name << " OK\n";
+        return true;
+    } catch(const std::exception& e) {
+        std::cerr << name << " FAILED: " << e.what() << '\n';
+        return false;
+    }
+}
+
+}  // namespace testing
+
+#define ASSERT(expr) testing::Assert(static_cast<bool>(expr), #expr, __FILE__, __LINE__)
+#define ASSERT_EQUAL(lhs, rhs) testing::AssertEqual((lhs), (rhs), #lhs, #rhs, __FILE__, __LINE__)
+#define ASSERT_NEAR(lhs, rhs, tolerance) \
+    testing::AssertNear((lhs), (rhs), (tolerance), #lhs, #rhs, __FILE__, __LINE__)
+#define RUN_TEST(func) testing::RunTest(func, #func)
@@ -0,0 +1,45 @@
+#include "thread_pool.h"
+
+namespace threads {
+
+ThreadPool::ThreadPool(size_t threads_count) {
+    workers_.reserve(threads_count);
+    for(size_t i = 0; i < threads_count; ++i) {
+        workers_.emplace_back([this](std::stop_token stop) {
+            Work(stop);
+        });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    for(auto& worker : workers_) {
+        worker.request_stop();
+    }
+    workers_.clear();
+}
+
+void ThreadPool::Push(std::function<void()> task) {
+    {
+        std::lock_guard lock(mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    has_tasks_.notify_one();
+}
+
+void ThreadPool::Work(std::stop_token stop) {
+    while(true) {
+        std::function<void()> task;
+        {
+            std::unique_lock lock(mutex_);
+            // после запроса остановки ожидание прерывается, но оставшиеся задачи выполняются
+            if(!has_tasks_.wait(lock, stop, [this] { return !tasks_.empty(); })) {
+                return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        task();
+    }
+}
+
+}  // namespace threads
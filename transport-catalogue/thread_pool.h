@@ -0,0 +1,51 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace threads {
+
+// Пул потоков с общей очередью задач. Один пул обслуживает все сети процесса,
+// поэтому число рабочих потоков не растёт с числом сетей
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threads_count = std::max(1u, std::thread::hardware_concurrency()));
+
+    // при разрушении дожидается выполнения уже поставленных задач
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // ставит func в очередь; исключение из func передаётся через future
+    template <typename Func>
+    std::future<std::invoke_result_t<Func>> Submit(Func func) {
+        auto task = std::make_shared<std::packaged_task<std::invoke_result_t<Func>()>>(std::move(func));
+        auto result = task->get_future();
+        Push([task] {
+            (*task)();
+        });
+        return result;
+    }
+
+private:
+    void Push(std::function<void()> task);
+    // цикл рабочего потока: берёт задачи, пока не запрошена остановка и очередь не пуста
+    void Work(std::stop_token stop);
+
+    std::mutex mutex_;
+    std::condition_variable_any has_tasks_;
+    std::deque<std::function<void()>> tasks_;
+    // объявлены последними: потоки останавливаются до разрушения очереди
+    std::vector<std::jthread> workers_;
+};
+
+}  // namespace threads
@@ -1,38 +1,553 @@
 #include <numeric>
 #include <algorithm>
-#include <unordered_set>
 #include <cassert>
+#include <stdexcept>
+#include <string>
+#include <thread>
 #include "transport_catalogue.h"
+#include "memory_usage.h"
+
+using namespace std::literals;
 
 namespace catalogue {
 
+namespace {
+// вызывает func(begin, end) для частей диапазона [0, count) в нескольких потоках
+template <typename Func>
+void ParallelFor(size_t count, Func func) {
+    const size_t threads_count = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), count);
+    if(threads_count <= 1) {
+        func(size_t{0}, count);
+        return;
+    }
+    const size_t chunk = (count + threads_count - 1) / threads_count;
+    std::vector<std::jthread> threads;
+    threads.reserve(threads_count - 1);
+    // первую часть обрабатывает текущий поток
+    for(size_t begin = chunk; begin < count; begin += chunk) {
+        threads.emplace_back(func, begin, std::min(begin + chunk, count));
+    }
+    func(size_t{0}, std::min(chunk, count));
+}
+
+// меньше этого числа затронутых маршрутов UpdateDistances пересчитывает в текущем потоке:
+// запуск потоков на каждое изменение дороже самого расчёта
+const size_t PARALLEL_UPDATE_MIN_BUSES = 256;
+
+// ключ индекса отрезков: пара остановок без учёта направления
+uint64_t SegmentKey(StopId from, StopId to) {
+    if(from > to) {
+        std::swap(from, to);
+    }
+    return (uint64_t{from} << 32) | to;
+}
+
+// строит совершенную хеш-функцию по названиям элементов и раскладывает их id по ячейкам
+template <typename Items, typename Id>
+std::pair<PerfectHashFunction, std::vector<Id>> BuildNamesHash(const Items& items) {
+    std::vector<std::string_view> keys;
+    keys.reserve(items.size());
+    for(const auto& item : items) {
+        keys.push_back(item.name);
+    }
+    PerfectHashFunction function(keys);
+    std::vector<Id> by_slot(items.size());
+    for(const auto& item : items) {
+        by_slot[function(item.name)] = item.id;
+    }
+    return {std::move(function), std::move(by_slot)};
+}
+
+// заменяет в отсортированном списке id old_id на new_id, сохраняя порядок
+void ReplaceSortedId(std::vector<BusId>& ids, BusId old_id, BusId new_id) {
+    auto pos = std::lower_bound(ids.begin(), ids.end(), old_id);
+    if(pos == ids.end() || *pos != old_id) {
+        return;
+    }
+    ids.erase(pos);
+    ids.insert(std::lower_bound(ids.begin(), ids.end(), new_id), new_id);
+}
+}  // namespace
+
+TransportCatalogue::TransportCatalogue(StatsMode stats_mode) : stats_mode_{stats_mode} {
+}
+
 // добавление остановки в базу
 void TransportCatalogue::AddStop(const Stop& stop) {
+    AssertNotFrozen();
     auto new_stop = stops_.insert(stops_.end(), std::move(stop));
+    new_stop->id = static_cast<StopId>(stops_.size() - 1);
+    new_stop->name = names_.Intern(new_stop->name);
+    stops_points_.push_back(ToSpherePoint(new_stop->coord));
     find_stops_[new_stop->name] = &(*new_stop);
-    stops_info_.insert({&(*new_stop), {}});
+    stops_info_.emplace_back();
 }
 
 // Добавление расстояния между остановками
 void TransportCatalogue::AddDistanceBetweenStops(std::string_view from, std::string_view to, size_t distance) {
-    stops_distances_[{find_stops_[from], find_stops_[to]}] = distance;
+    AssertNotFrozen();
+    const Stop* stop_from = GetStop(from);
+    const Stop* stop_to = GetStop(to);
+    if(!stop_from || !stop_to) {
+        return;
+    }
+    stops_distances_.Add(stop_from->id, stop_to->id, distance);
+}
+
+void TransportCatalogue::AddDistanceBetweenStops(StopId from, StopId to, size_t distance) {
+    AssertNotFrozen();
+    if(from >= stops_.size() || to >= stops_.size()) {
+        return;
+    }
+    stops_distances_.Add(from, to, distance);
 }
 
 // добавление маршрута в базу
 void TransportCatalogue::AddBus(const Bus& bus) {
-    auto new_bus = buses_.insert(buses_.end(), std::move(bus));
-    find_buses_[new_bus->name] = &(*new_bus);
+    AssertNotFrozen();
+    auto new_bus = &InsertBus(bus);
 
     // добавляем в route_info_ статистику маршрута автобуса bus
-    route_info_[&(*new_bus)] = std::move(CalcBusStatistics(*new_bus));
+    if(stats_mode_ == StatsMode::EAGER) {
+        route_info_.push_back(CalcBusStatistics(*new_bus));
+    } else {
+        route_info_.emplace_back();
+        route_info_ready_.emplace_back();
+    }
+    AddBusToStops(*new_bus);
+}
+
+// добавление маршрута с заранее рассчитанной статистикой
+void TransportCatalogue::AddBus(const Bus& bus, const BusStats& stats) {
+    AssertNotFrozen();
+    const Bus& new_bus = InsertBus(bus);
+    route_info_.push_back(stats);
+    if(stats_mode_ == StatsMode::LAZY) {
+        // статистика уже известна, отмечаем её как рассчитанную
+        std::call_once(route_info_ready_.emplace_back(), [] {});
+    }
+    AddBusToStops(new_bus);
+}
+
+// добавляет маршрут в списки автобусов его остановок
+void TransportCatalogue::AddBusToStops(const Bus& bus) {
     // добавляем в stops_info_ для каждой остановки маршрута bus номер автобуса
-    std::for_each(bus.stops.begin(), bus.stops.end(), [this, new_bus](const Stop* stop) {
-        stops_info_[stop].insert(new_bus->name);
+    std::for_each(bus.stops.begin(), bus.stops.end(), [this, &bus](StopId stop) {
+        auto& buses = stops_info_[stop];
+        auto pos = std::lower_bound(buses.begin(), buses.end(), bus.name, [this](BusId id, std::string_view name) {
+            return buses_[id].name < name;
+        });
+        if(pos == buses.end() || *pos != bus.id) {
+            buses.insert(pos, bus.id);
+        }
+    });
+}
+
+// убирает маршрут из списков автобусов его остановок
+void TransportCatalogue::RemoveBusFromStops(const Bus& bus) {
+    for(StopId stop : bus.stops) {
+        auto& buses = stops_info_[stop];
+        auto pos = std::find(buses.begin(), buses.end(), bus.id);
+        if(pos != buses.end()) {
+            buses.erase(pos);
+        }
+    }
+}
+
+// строит индекс отрезков, если он ещё не построен
+void TransportCatalogue::BuildSegmentIndex() {
+    if(has_segment_index_) {
+        return;
+    }
+    for(const Bus& bus : buses_) {
+        AddBusToSegments(bus);
+    }
+    has_segment_index_ = true;
+}
+
+// добавляет маршрут в индекс отрезков
+void TransportCatalogue::AddBusToSegments(const Bus& bus) {
+    for(size_t i = 1; i < bus.stops.size(); ++i) {
+        auto& buses = segment_buses_[SegmentKey(bus.stops[i - 1], bus.stops[i])];
+        auto pos = std::lower_bound(buses.begin(), buses.end(), bus.id);
+        if(pos == buses.end() || *pos != bus.id) {
+            buses.insert(pos, bus.id);
+        }
+    }
+}
+
+// убирает маршрут из индекса отрезков
+void TransportCatalogue::RemoveBusFromSegments(const Bus& bus) {
+    for(size_t i = 1; i < bus.stops.size(); ++i) {
+        auto iter = segment_buses_.find(SegmentKey(bus.stops[i - 1], bus.stops[i]));
+        if(iter == segment_buses_.end()) {
+            continue;
+        }
+        auto& buses = iter->second;
+        auto pos = std::lower_bound(buses.begin(), buses.end(), bus.id);
+        if(pos != buses.end() && *pos == bus.id) {
+            buses.erase(pos);
+        }
+        if(buses.empty()) {
+            segment_buses_.erase(iter);
+        }
+    }
+}
+
+// сохраняет статистику маршрута
+void TransportCatalogue::SetRouteInfo(BusId bus, const BusStats& stats) {
+    route_info_[bus] = stats;
+    if(stats_mode_ == StatsMode::LAZY) {
+        // если статистика уже запрашивалась, флаг установлен и значение просто заменяется
+        std::call_once(route_info_ready_[bus], [] {});
+    }
+}
+
+// задаёт расстояние и пересчитывает статистику затронутых маршрутов
+void TransportCatalogue::UpdateDistance(std::string_view from, std::string_view to, size_t distance) {
+    UpdateDistances({DistanceDescription{from, to, distance}});
+}
+
+void TransportCatalogue::UpdateDistances(const std::vector<DistanceDescription>& distances) {
+    AssertNotFrozen();
+    BuildSegmentIndex();
+    std::vector<BusId> affected;
+    for(const auto& [from, to, distance] : distances) {
+        const Stop* stop_from = GetStop(from);
+        const Stop* stop_to = GetStop(to);
+        if(!stop_from || !stop_to) {
+            throw std::out_of_range("Unknown stop in distance update"s);
+        }
+        stops_distances_.Add(stop_from->id, stop_to->id, distance);
+        auto iter = segment_buses_.find(SegmentKey(stop_from->id, stop_to->id));
+        if(iter != segment_buses_.end()) {
+            affected.insert(affected.end(), iter->second.begin(), iter->second.end());
+        }
+    }
+    std::sort(affected.begin(), affected.end());
+    affected.erase(std::unique(affected.begin(), affected.end()), affected.end());
+
+    auto update = [this, &affected](size_t begin, size_t end) {
+        for(size_t i = begin; i < end; ++i) {
+            SetRouteInfo(affected[i], CalcBusStatistics(buses_[affected[i]]));
+        }
+    };
+    if(affected.size() < PARALLEL_UPDATE_MIN_BUSES) {
+        update(0, affected.size());
+    } else {
+        ParallelFor(affected.size(), update);
+    }
+}
+
+// удаляет маршрут, освободившийся id занимает последний маршрут
+void TransportCatalogue::RemoveBus(std::string_view bus_name) {
+    AssertNotFrozen();
+    const Bus* bus = GetBus(bus_name);
+    if(!bus) {
+        throw std::out_of_range("Unknown bus \""s + std::string(bus_name) + "\""s);
+    }
+    const BusId id = bus->id;
+    const BusId last = static_cast<BusId>(buses_.size() - 1);
+    RemoveBusFromStops(*bus);
+    if(has_segment_index_) {
+        RemoveBusFromSegments(*bus);
+    }
+    find_buses_.erase(bus->name);
+
+    if(id != last) {
+        const Bus& moved = buses_[last];
+        // списки автобусов остановок упорядочены по названию, поэтому смена id не меняет позиций
+        for(StopId stop : moved.stops) {
+            auto& buses = stops_info_[stop];
+            std::replace(buses.begin(), buses.end(), last, id);
+        }
+        if(has_segment_index_) {
+            for(size_t i = 1; i < moved.stops.size(); ++i) {
+                ReplaceSortedId(segment_buses_[SegmentKey(moved.stops[i - 1], moved.stops[i])], last, id);
+            }
+        }
+        buses_stops_[id].swap(buses_stops_[last]);
+        buses_[id] = moved;
+        buses_[id].id = id;
+        buses_[id].stops = buses_stops_[id];
+        find_buses_[buses_[id].name] = &buses_[id];
+        if(stats_mode_ == StatsMode::LAZY) {
+            // флаг id относится к удалённому маршруту, поэтому статистику переносимого считаем сразу
+            SetRouteInfo(id, CalcBusStatistics(buses_[id]));
+        } else {
+            route_info_[id] = route_info_[last];
+        }
+    }
+    buses_.pop_back();
+    buses_stops_.pop_back();
+    route_info_.pop_back();
+    if(stats_mode_ == StatsMode::LAZY) {
+        route_info_ready_.pop_back();
+    }
+}
+
+// заменяет остановки и признак кольцевого маршрута
+void TransportCatalogue::ReplaceBus(const Bus& bus) {
+    AssertNotFrozen();
+    const Bus* old_bus = GetBus(bus.name);
+    if(!old_bus) {
+        throw std::out_of_range("Unknown bus \""s + std::string(bus.name) + "\""s);
+    }
+    const BusId id = old_bus->id;
+    Bus& target = buses_[id];
+    RemoveBusFromStops(target);
+    if(has_segment_index_) {
+        RemoveBusFromSegments(target);
+    }
+    // bus.stops может указывать на текущие остановки маршрута, поэтому сначала копируем
+    std::vector<StopId> stops(bus.stops.begin(), bus.stops.end());
+    buses_stops_[id] = std::move(stops);
+    target.stops = buses_stops_[id];
+    target.is_roundtrip = bus.is_roundtrip;
+    AddBusToStops(target);
+    if(has_segment_index_) {
+        AddBusToSegments(target);
+    }
+    SetRouteInfo(id, CalcBusStatistics(target));
+}
+
+// пакетная загрузка остановок, расстояний и маршрутов
+void TransportCatalogue::AddBulk(const std::vector<Stop>& stops, const std::vector<DistanceDescription>& distances,
+                                 const std::vector<BusDescription>& buses) {
+    AssertNotFrozen();
+    for(const Stop& stop : stops) {
+        AddStop(stop);
+    }
+    for(const auto& [from, to, distance] : distances) {
+        AddDistanceBetweenStops(from, to, distance);
+    }
+
+    // сохраняем маршруты без расчёта статистики
+    const BusId first_bus = static_cast<BusId>(buses_.size());
+    for(const BusDescription& description : buses) {
+        std::vector<StopId> stops;
+        stops.reserve(description.stops.size());
+        for(std::string_view stop_name : description.stops) {
+            const Stop* stop = GetStop(stop_name);
+            if(!stop) {
+                throw std::out_of_range("Unknown stop \""s + std::string(stop_name) + "\" in bus route"s);
+            }
+            stops.push_back(stop->id);
+        }
+        const Bus& new_bus = InsertBus(Bus{description.name, stops, description.is_roundtrip});
+        for(StopId stop : new_bus.stops) {
+            stops_info_[stop].push_back(new_bus.id);
+        }
+    }
+
+    // статистика маршрутов независима, считаем её параллельно
+    route_info_.resize(buses_.size());
+    if(stats_mode_ == StatsMode::EAGER) {
+        ParallelFor(buses_.size() - first_bus, [this, first_bus](size_t begin, size_t end) {
+            for(size_t i = first_bus + begin; i < first_bus + end; ++i) {
+                route_info_[i] = CalcBusStatistics(buses_[i]);
+            }
+        });
+    } else {
+        while(route_info_ready_.size() < buses_.size()) {
+            route_info_ready_.emplace_back();
+        }
+    }
+    // списки автобусов остановок приводим к отсортированному виду без повторов
+    ParallelFor(stops_info_.size(), [this](size_t begin, size_t end) {
+        for(size_t i = begin; i < end; ++i) {
+            auto& buses = stops_info_[i];
+            std::sort(buses.begin(), buses.end(), [this](BusId lhs, BusId rhs) {
+                return std::pair{buses_[lhs].name, lhs} < std::pair{buses_[rhs].name, rhs};
+            });
+            buses.erase(std::unique(buses.begin(), buses.end()), buses.end());
+        }
     });
 }
 
+// завершает заполнение: упаковывает данные в компактные структуры для чтения
+void TransportCatalogue::Freeze() {
+    if(is_frozen_) {
+        return;
+    }
+    // списки автобусов остановок переносим в единый массив со смещениями
+    size_t total = 0;
+    for(const auto& buses : stops_info_) {
+        total += buses.size();
+    }
+    std::vector<BusId> stop_buses;
+    std::vector<uint32_t> stop_buses_offsets;
+    stop_buses.reserve(total);
+    stop_buses_offsets.reserve(stops_info_.size() + 1);
+    stop_buses_offsets.push_back(0);
+    for(const auto& buses : stops_info_) {
+        stop_buses.insert(stop_buses.end(), buses.begin(), buses.end());
+        stop_buses_offsets.push_back(static_cast<uint32_t>(stop_buses.size()));
+    }
+    stop_buses_ = FrozenArray<BusId>(std::move(stop_buses));
+    stop_buses_offsets_ = FrozenArray<uint32_t>(std::move(stop_buses_offsets));
+    std::vector<std::vector<BusId>>{}.swap(stops_info_);
+    std::unordered_map<uint64_t, std::vector<BusId>>{}.swap(segment_buses_);
+    has_segment_index_ = false;
+
+    stops_distances_.Compact();
+    route_info_.shrink_to_fit();
+    stops_points_.shrink_to_fit();
+    names_.ReleaseIndex();
+
+    BuildFrozenIndexes();
+}
+
+// заполняет пустой справочник упакованными данными без копирования массивов
+void TransportCatalogue::Attach(const FrozenData& data, std::shared_ptr<const void> storage) {
+    AssertNotFrozen();
+    if(!stops_.empty() || !buses_.empty()) {
+        throw std::logic_error("Transport catalogue is not empty");
+    }
+    storage_ = std::move(storage);
+    const FrozenIndexes& indexes = data.indexes;
+    has_perfect_hash_ = indexes.stops_hash.size == data.stops_coords.size()
+                        && indexes.stops_by_slot.size() == indexes.stops_hash.size
+                        && indexes.buses_hash.size == data.buses_stats.size()
+                        && indexes.buses_by_slot.size() == indexes.buses_hash.size;
+
+    const std::string_view stops_names{data.stops_names.data(), data.stops_names.size()};
+    for(StopId id = 0; id < data.stops_coords.size(); ++id) {
+        const auto begin = data.stops_names_offsets[id];
+        const Stop& stop = stops_.emplace_back(
+            Stop{stops_names.substr(begin, data.stops_names_offsets[id + 1] - begin), data.stops_coords[id], id});
+        if(!has_perfect_hash_) {
+            find_stops_[stop.name] = &stop;
+        }
+    }
+    // маршрутов немного, таблица по ним нужна GetAllRoutes
+    const std::string_view buses_names{data.buses_names.data(), data.buses_names.size()};
+    for(BusId id = 0; id < data.buses_stats.size(); ++id) {
+        const auto name_begin = data.buses_names_offsets[id];
+        const auto stops_begin = data.buses_stops_offsets[id];
+        const Bus& bus = buses_.emplace_back(
+            Bus{buses_names.substr(name_begin, data.buses_names_offsets[id + 1] - name_begin),
+                data.buses_stops.subspan(stops_begin, data.buses_stops_offsets[id + 1] - stops_begin),
+                data.buses_roundtrip[id] != 0, id});
+        find_buses_[bus.name] = &bus;
+    }
+    attached_route_info_ = data.buses_stats;
+    stop_buses_ = FrozenArray<BusId>(data.stop_buses);
+    stop_buses_offsets_ = FrozenArray<uint32_t>(data.stop_buses_offsets);
+    stops_distances_.Attach(data.distances_offsets, data.distances);
+    stops_info_.clear();
+
+    if(has_perfect_hash_) {
+        stops_hash_ = PerfectHashFunction(indexes.stops_hash);
+        stops_by_slot_ = FrozenArray<StopId>(indexes.stops_by_slot);
+        buses_hash_ = PerfectHashFunction(indexes.buses_hash);
+        buses_by_slot_ = FrozenArray<BusId>(indexes.buses_by_slot);
+    }
+    stops_index_ = SpatialIndex(indexes.stops_index);
+    stops_names_index_ = NameIndex(indexes.stops_names_index);
+    is_frozen_ = true;
+}
+
+FrozenIndexes TransportCatalogue::GetFrozenIndexes() const {
+    AssertFrozen();
+    return {stops_hash_.GetData(), stops_by_slot_.GetView(), buses_hash_.GetData(), buses_by_slot_.GetView(),
+            stops_index_.GetData(), stops_names_index_.GetData()};
+}
+
+// строит индексы для чтения и замораживает справочник
+void TransportCatalogue::BuildFrozenIndexes() {
+    std::vector<geo::CompactCoordinates> coords;
+    std::vector<std::pair<std::string_view, StopId>> names;
+    coords.reserve(stops_.size());
+    names.reserve(stops_.size());
+    for(const Stop& stop : stops_) {
+        coords.push_back(stop.coord);
+        names.emplace_back(stop.name, stop.id);
+    }
+    stops_index_ = SpatialIndex(coords);
+    stops_names_index_ = NameIndex(std::move(names));
+
+    // индексы больше не растут, оставляем минимально необходимое число корзин
+    find_stops_.rehash(0);
+    find_buses_.rehash(0);
+    BuildPerfectHash();
+    // остановки ищутся по совершенному хешированию, как после Attach; таблица маршрутов нужна GetAllRoutes
+    if(has_perfect_hash_) {
+        std::unordered_map<std::string_view, const Stop*>{}.swap(find_stops_);
+    }
+
+    is_frozen_ = true;
+}
+
+// строит совершенные хеш-функции названий; при неудаче оставляет поиск на хеш-таблицах
+void TransportCatalogue::BuildPerfectHash() {
+    try {
+        auto [stops_hash, stops_by_slot] = BuildNamesHash<std::deque<Stop>, StopId>(stops_);
+        auto [buses_hash, buses_by_slot] = BuildNamesHash<std::deque<Bus>, BusId>(buses_);
+        stops_hash_ = std::move(stops_hash);
+        stops_by_slot_ = FrozenArray<StopId>(std::move(stops_by_slot));
+        buses_hash_ = std::move(buses_hash);
+        buses_by_slot_ = FrozenArray<BusId>(std::move(buses_by_slot));
+        has_perfect_hash_ = true;
+    } catch(const std::runtime_error&) {
+        has_perfect_hash_ = false;
+    }
+}
+
+bool TransportCatalogue::IsFrozen() const {
+    return is_frozen_;
+}
+
+std::span<const uint32_t> TransportCatalogue::GetStopBusesOffsets() const {
+    AssertFrozen();
+    return stop_buses_offsets_.GetView();
+}
+
+std::span<const BusId> TransportCatalogue::GetStopBuses() const {
+    AssertFrozen();
+    return stop_buses_.GetView();
+}
+
+const RoadDistances& TransportCatalogue::GetRoadDistances() const {
+    return stops_distances_;
+}
+
+// выбрасывает исключение при попытке изменить замороженный справочник
+void TransportCatalogue::AssertNotFrozen() const {
+    if(is_frozen_) {
+        throw std::logic_error("Transport catalogue is frozen");
+    }
+}
+
+// выбрасывает исключение при обращении к данным, которые строятся при заморозке
+void TransportCatalogue::AssertFrozen() const {
+    if(!is_frozen_) {
+        throw std::logic_error("Transport catalogue is not frozen");
+    }
+}
+
+// сохраняет маршрут и добавляет его в индекс, статистика не рассчитывается
+Bus& TransportCatalogue::InsertBus(const Bus& bus) {
+    Bus& new_bus = buses_.emplace_back(bus);
+    new_bus.id = static_cast<BusId>(buses_.size() - 1);
+    new_bus.name = names_.Intern(new_bus.name);
+    new_bus.stops = buses_stops_.emplace_back(bus.stops.begin(), bus.stops.end());
+    find_buses_[new_bus.name] = &new_bus;
+    if(has_segment_index_) {
+        AddBusToSegments(new_bus);
+    }
+    return new_bus;
+}
+
 // поиск остановки по имени
 const Stop* TransportCatalogue::GetStop(std::string_view stop_name) const {
+    if(has_perfect_hash_) {
+        if(stops_by_slot_.empty()) {
+            return nullptr;
+        }
+        const Stop& stop = stops_[stops_by_slot_[stops_hash_(stop_name)]];
+        return stop.name == stop_name ? &stop : nullptr;
+    }
     auto iter = find_stops_.find(stop_name);
     if(iter == find_stops_.end()) {
         return nullptr;
@@ -42,6 +557,13 @@ const Stop* TransportCatalogue::GetStop(std::string_view stop_name) const {
 
 // поиск маршрута по имени
 const Bus* TransportCatalogue::GetBus(std::string_view bus_name) const {
+    if(has_perfect_hash_) {
+        if(buses_by_slot_.empty()) {
+            return nullptr;
+        }
+        const Bus& bus = buses_[buses_by_slot_[buses_hash_(bus_name)]];
+        return bus.name == bus_name ? &bus : nullptr;
+    }
     auto iter = find_buses_.find(bus_name);
     if(iter == find_buses_.end()) {
         return nullptr;
@@ -49,32 +571,50 @@ const Bus* TransportCatalogue::GetBus(std::string_view bus_name) const {
     return iter->second;
 }
 
+// поиск остановки по идентификатору
+const Stop* TransportCatalogue::GetStopById(StopId id) const {
+    if(id >= stops_.size()) {
+        return nullptr;
+    }
+    return &stops_[id];
+}
+
+// поиск маршрута по идентификатору
+const Bus* TransportCatalogue::GetBusById(BusId id) const {
+    if(id >= buses_.size()) {
+        return nullptr;
+    }
+    return &buses_[id];
+}
+
+size_t TransportCatalogue::GetStopsCount() const {
+    return stops_.size();
+}
+
+size_t TransportCatalogue::GetBusesCount() const {
+    return buses_.size();
+}
+
 // возвращает количество уникальных остановок маршрута
 size_t TransportCatalogue::GetUniqueStops(const Bus& bus) const {
-    std::unordered_set<const Stop*> unique_stops(bus.stops.begin(), bus.stops.end());
-    return unique_stops.size();
+    std::vector<StopId> unique_stops(bus.stops.begin(), bus.stops.end());
+    std::sort(unique_stops.begin(), unique_stops.end());
+    return std::unique(unique_stops.begin(), unique_stops.end()) - unique_stops.begin();
 }
 
 // возвращает географическую длину всего маршрута 
 double TransportCatalogue::GetRouteLengthG(const Bus& bus) const {
-    auto calc_sum = [](double lhs, double rhs) {
-        return lhs + rhs;
-    };
-    auto calc_distance = [](const Stop* lhs, const Stop* rhs) {
-        return ComputeDistance(lhs->coord, rhs->coord);
-    };
-    return std::transform_reduce(bus.stops.begin(), bus.stops.end() - 1, bus.stops.begin() + 1, 0.0, 
-                     calc_sum, calc_distance);
+    return ComputePathLength(stops_points_, bus.stops, !bus.is_roundtrip);
 }
 
 // возвращает фактическую дину всего маршрута
 size_t TransportCatalogue::GetRouteLengthF(const Bus& bus) const {
     size_t distance = 0;
     for(size_t i = 1; i < bus.stops.size(); ++i) {
-        if(auto iter = stops_distances_.find(std::pair{bus.stops[i - 1], bus.stops[i]}); iter != stops_distances_.end()) {
-            distance += iter->second;
-        } else if(auto iter = stops_distances_.find(std::pair{bus.stops[i], bus.stops[i - 1]}); iter != stops_distances_.end()) {
-            distance += iter->second;
+        distance += stops_distances_.Find(bus.stops[i - 1], bus.stops[i]).value_or(0);
+        // обратный путь некольцевого маршрута
+        if(!bus.is_roundtrip) {
+            distance += stops_distances_.Find(bus.stops[i], bus.stops[i - 1]).value_or(0);
         }
     }
     return distance;
@@ -84,19 +624,47 @@ size_t TransportCatalogue::GetRouteLengthF(const Bus& bus) const {
 BusStats TransportCatalogue::CalcBusStatistics(const Bus& bus) const {
     size_t length_f = GetRouteLengthF(bus);
     double curvature = length_f / GetRouteLengthG(bus);
-    return BusStats{bus.stops.size(), GetUniqueStops(bus), length_f, curvature};
+    return BusStats{RouteStops(bus).size(), GetUniqueStops(bus), length_f, curvature};
 }
 
 // получение информации о маршруте Bus X: R stops on route, U unique stops, L route length
+const BusStats& TransportCatalogue::GetRouteInfo(BusId bus) const {
+    if(!attached_route_info_.empty()) {
+        if(bus >= attached_route_info_.size()) {
+            throw std::out_of_range("Unknown bus id");
+        }
+        return attached_route_info_[bus];
+    }
+    if(stats_mode_ == StatsMode::LAZY) {
+        std::call_once(route_info_ready_.at(bus), [this, bus] {
+            route_info_[bus] = CalcBusStatistics(buses_[bus]);
+        });
+    }
+    return route_info_.at(bus);
+}
+
 const BusStats& TransportCatalogue::GetRouteInfo(const Bus* bus) const {
     assert(bus);
-    return route_info_.at(bus);
+    return GetRouteInfo(bus->id);
 }
 
 // получение информации об остановке
-const std::set<std::string_view>& TransportCatalogue::GetStopInfo(const Stop* stop) const {
+StopBuses TransportCatalogue::GetStopInfo(StopId stop) const {
+    if(!is_frozen_) {
+        const auto& buses = stops_info_.at(stop);
+        return {BusNamesIterator{buses.data(), &buses_}, BusNamesIterator{buses.data() + buses.size(), &buses_}};
+    }
+    if(stop + 1 >= stop_buses_offsets_.size()) {
+        throw std::out_of_range("Unknown stop id");
+    }
+    const BusId* buses = stop_buses_.data();
+    return {BusNamesIterator{buses + stop_buses_offsets_[stop], &buses_},
+            BusNamesIterator{buses + stop_buses_offsets_[stop + 1], &buses_}};
+}
+
+StopBuses TransportCatalogue::GetStopInfo(const Stop* stop) const {
     assert(stop);
-    return stops_info_.at(stop);
+    return GetStopInfo(stop->id);
 }
 
 // получение всех маршрутов
@@ -104,18 +672,78 @@ const std::unordered_map<std::string_view, const Bus*>& TransportCatalogue::GetA
     return find_buses_;
 }
 
-// получение всех остановок
+// получение всех остановок; после заморозки или Attach с готовыми хеш-функциями таблица строится при вызове
 const std::unordered_map<std::string_view, const Stop*> TransportCatalogue::GetAllStops() const {
-    return find_stops_;
+    if(find_stops_.size() == stops_.size()) {
+        return find_stops_;
+    }
+    std::unordered_map<std::string_view, const Stop*> stops;
+    for(const Stop& stop : stops_) {
+        stops[stop.name] = &stop;
+    }
+    return stops;
 }
 
 // получение расстояния между двумя остановками
+size_t TransportCatalogue::GetDistanceBetweenStops(StopId from, StopId to) const {
+    auto distance = stops_distances_.Find(from, to);
+    if(!distance) {
+        throw std::out_of_range("Distance between stops is not set");
+    }
+    return *distance;
+}
+
 size_t TransportCatalogue::GetDistanceBetweenStops(const Stop* from, const Stop* to) const {
-    auto iter = stops_distances_.find({from, to});
-    if(iter != stops_distances_.end()) {
-        return iter->second;
+    assert(from && to);
+    return GetDistanceBetweenStops(from->id, to->id);
+}
+
+// приблизительный объём собственной памяти
+size_t TransportCatalogue::GetMemoryUsage() const {
+    return names_.GetMemoryUsage()
+           + memory::GetUsage(stops_) + memory::GetUsage(buses_) + memory::GetUsage(buses_stops_)
+           + memory::GetUsage(stops_points_)
+           + memory::GetUsage(find_stops_) + memory::GetUsage(find_buses_)
+           + stops_hash_.GetMemoryUsage() + stops_by_slot_.GetMemoryUsage()
+           + buses_hash_.GetMemoryUsage() + buses_by_slot_.GetMemoryUsage()
+           + memory::GetUsage(route_info_) + memory::GetUsage(route_info_ready_)
+           + memory::GetUsage(stops_info_) + stop_buses_.GetMemoryUsage() + stop_buses_offsets_.GetMemoryUsage()
+           + stops_distances_.GetMemoryUsage() + memory::GetUsage(segment_buses_)
+           + stops_index_.GetMemoryUsage() + stops_names_index_.GetMemoryUsage();
+}
+
+// поиск ближайших к точке остановок
+std::vector<NearbyStop> TransportCatalogue::GetNearestStops(geo::Coordinates point, size_t count, double radius) const {
+    AssertFrozen();
+    std::vector<NearbyStop> result;
+    for(const auto& [id, distance] : stops_index_.FindNearest(point, count, radius)) {
+        result.push_back({&stops_[id], distance});
+    }
+    return result;
+}
+
+// поиск остановок внутри прямоугольника координат
+std::vector<const Stop*> TransportCatalogue::GetStopsInBox(geo::Coordinates min, geo::Coordinates max) const {
+    AssertFrozen();
+    std::vector<const Stop*> result;
+    for(StopId id : stops_index_.FindInBox(min, max)) {
+        result.push_back(&stops_[id]);
+    }
+    std::sort(result.begin(), result.end(), [](const Stop* lhs, const Stop* rhs) {
+        return lhs->name < rhs->name;
+    });
+    return result;
+}
+
+// поиск остановок по началу названия с возможными опечатками
+std::vector<const Stop*> TransportCatalogue::SearchStops(std::string_view query, size_t max_distance,
+                                                         size_t limit) const {
+    AssertFrozen();
+    std::vector<const Stop*> result;
+    for(StopId id : stops_names_index_.Find(query, max_distance, limit)) {
+        result.push_back(&stops_[id]);
     }
-    return stops_distances_.at(std::pair(to, from));
+    return result;
 }
 
 }// namespace catalogue
\ No newline at end of file
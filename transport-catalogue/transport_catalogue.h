@@ -2,25 +2,188 @@
 
 #include <string_view>
 #include <deque>
-#include <set>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <span>
 #include <unordered_map>
 #include <map>
+#include <vector>
 
 #include "domain.h"
+#include "frozen_array.h"
+#include "name_index.h"
+#include "perfect_hash.h"
+#include "ranges.h"
+#include "road_distances.h"
+#include "spatial_index.h"
+#include "string_arena.h"
 
 namespace catalogue {
 
 using namespace domain;
 
+// итератор по названиям маршрутов, заданных идентификаторами
+class BusNamesIterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const std::string_view*;
+    using reference = std::string_view;
+
+    BusNamesIterator() = default;
+    BusNamesIterator(const BusId* pos, const std::deque<Bus>* buses)
+        : pos_{pos}
+        , buses_{buses} {
+    }
+
+    std::string_view operator*() const {
+        return (*buses_)[*pos_].name;
+    }
+
+    BusNamesIterator& operator++() {
+        ++pos_;
+        return *this;
+    }
+
+    BusNamesIterator operator++(int) {
+        auto old = *this;
+        ++pos_;
+        return old;
+    }
+
+    bool operator==(const BusNamesIterator& other) const {
+        return pos_ == other.pos_;
+    }
+
+private:
+    const BusId* pos_ = nullptr;
+    const std::deque<Bus>* buses_ = nullptr;
+};
+
+// отсортированные по алфавиту названия автобусов, проходящих через остановку
+using StopBuses = ranges::Range<BusNamesIterator>;
+
+// расстояние между остановками для пакетной загрузки
+struct DistanceDescription {
+    std::string_view from;
+    std::string_view to;
+    size_t distance;
+};
+
+// маршрут для пакетной загрузки, остановки заданы названиями
+struct BusDescription {
+    std::string_view name;
+    std::vector<std::string_view> stops;
+    bool is_roundtrip;
+};
+
+// остановка рядом с заданной точкой
+struct NearbyStop {
+    const Stop* stop;
+    double distance;  // в метрах
+};
+
+// Индексы замороженного справочника в упакованном виде: совершенные хеш-функции названий
+// с id остановки (маршрута) в каждой ячейке, k-d дерево остановок и индекс их названий.
+// Хеш-функции пусты (size == 0 при непустом справочнике), если их не удалось построить
+struct FrozenIndexes {
+    PerfectHashFunction::Data stops_hash;
+    std::span<const StopId> stops_by_slot;
+    PerfectHashFunction::Data buses_hash;
+    std::span<const BusId> buses_by_slot;
+    SpatialIndex::Data stops_index;
+    NameIndex::Data stops_names_index;
+};
+
+// Упакованные данные замороженного справочника: массивы без указателей, связи заданы
+// идентификаторами и смещениями. Строка i массива со смещениями offsets - [offsets[i], offsets[i + 1])
+struct FrozenData {
+    // названия остановок и их координаты в порядке id
+    std::span<const uint32_t> stops_names_offsets;
+    std::span<const char> stops_names;
+    std::span<const CompactCoordinates> stops_coords;
+    // названия маршрутов, признаки кольцевого маршрута, остановки и статистика в порядке id
+    std::span<const uint32_t> buses_names_offsets;
+    std::span<const char> buses_names;
+    std::span<const uint8_t> buses_roundtrip;
+    std::span<const uint32_t> buses_stops_offsets;
+    std::span<const StopId> buses_stops;
+    std::span<const BusStats> buses_stats;
+    // маршруты, проходящие через остановку, отсортированные по названию
+    std::span<const uint32_t> stop_buses_offsets;
+    std::span<const BusId> stop_buses;
+    // расстояния в упакованном представлении RoadDistances
+    std::span<const uint32_t> distances_offsets;
+    std::span<const RoadDistances::Entry> distances;
+    // индексы для чтения
+    FrozenIndexes indexes;
+};
+
+// момент расчёта статистики маршрутов
+enum class StatsMode {
+    EAGER,  // при добавлении маршрута
+    LAZY    // при первом запросе статистики маршрута
+};
+
 class TransportCatalogue {
 public:
+    explicit TransportCatalogue(StatsMode stats_mode = StatsMode::EAGER);
+
     // добавление остановки в базу
     void AddStop(const Stop& stop);
 
     void AddDistanceBetweenStops(std::string_view from, std::string_view to, size_t distance);
+    void AddDistanceBetweenStops(StopId from, StopId to, size_t distance);
 
     // добавление маршрута в базу
     void AddBus(const Bus& bus);
+    // добавление маршрута с заранее рассчитанной статистикой (например, из снимка справочника)
+    void AddBus(const Bus& bus, const BusStats& stats);
+
+    // пакетная загрузка: добавляет остановки, затем расстояния и маршруты;
+    // статистика маршрутов и списки автобусов остановок рассчитываются параллельно,
+    // результат совпадает с последовательным добавлением через AddStop/AddDistanceBetweenStops/AddBus
+    void AddBulk(const std::vector<Stop>& stops, const std::vector<DistanceDescription>& distances,
+                 const std::vector<BusDescription>& buses);
+
+    // Изменение данных до заморозки. Статистика пересчитывается только у затронутых маршрутов,
+    // их поиск идёт по индексу отрезков, который строится при первом изменении
+
+    // задаёт расстояние так же, как AddDistanceBetweenStops, и пересчитывает статистику маршрутов,
+    // проезжающих между from и to в любом направлении; для неизвестной остановки выбрасывает std::out_of_range
+    void UpdateDistance(std::string_view from, std::string_view to, size_t distance);
+    // то же для набора расстояний: статистика каждого затронутого маршрута пересчитывается один раз
+    void UpdateDistances(const std::vector<DistanceDescription>& distances);
+    // удаляет маршрут; освободившийся id занимает последний маршрут, его id и адрес меняются.
+    // Для неизвестного маршрута выбрасывает std::out_of_range
+    void RemoveBus(std::string_view bus_name);
+    // заменяет остановки и признак кольцевого маршрута у маршрута с названием bus.name, id сохраняется.
+    // Для неизвестного маршрута выбрасывает std::out_of_range
+    void ReplaceBus(const Bus& bus);
+
+    // завершает заполнение: упаковывает данные в компактные структуры для чтения,
+    // после вызова справочник доступен только для чтения
+    void Freeze();
+
+    // заполняет пустой справочник упакованными данными без копирования массивов и замораживает его;
+    // индексы тоже подключаются готовыми, пересоздаются только записи Stop и Bus.
+    // storage - владелец памяти данных (например, отображённого файла), справочник хранит его до разрушения.
+    // Данные должны быть согласованы, их проверяет вызывающий (внутреннюю согласованность индексов
+    // проверяют сами индексы и выбрасывают std::runtime_error)
+    void Attach(const FrozenData& data, std::shared_ptr<const void> storage);
+
+    // индексы в упакованном виде (доступно после заморозки)
+    FrozenIndexes GetFrozenIndexes() const;
+
+    // маршруты, проходящие через остановку, в упакованном виде (доступно после заморозки)
+    std::span<const uint32_t> GetStopBusesOffsets() const;
+    std::span<const BusId> GetStopBuses() const;
+    // расстояния в упакованном виде (доступно после заморозки)
+    const RoadDistances& GetRoadDistances() const;
+
+    bool IsFrozen() const;
 
     // поиск остановки по имени
     const Stop* GetStop(std::string_view stop_name) const;
@@ -28,11 +191,23 @@ public:
     // поиск маршрута по имени
     const Bus* GetBus(std::string_view bus_name) const;
 
+    // поиск остановки по идентификатору
+    const Stop* GetStopById(StopId id) const;
+
+    // поиск маршрута по идентификатору
+    const Bus* GetBusById(BusId id) const;
+
+    // количество остановок и маршрутов, идентификаторы лежат в диапазонах [0, count)
+    size_t GetStopsCount() const;
+    size_t GetBusesCount() const;
+
     // получение информации о маршруте
+    const BusStats& GetRouteInfo(BusId bus) const;
     const BusStats& GetRouteInfo(const Bus* bus) const;
 
     // получение информации об остановке
-    const std::set<std::string_view>& GetStopInfo(const Stop* stop) const;
+    StopBuses GetStopInfo(StopId stop) const;
+    StopBuses GetStopInfo(const Stop* stop) const;
     
     // получение всех маршрутов
     const std::unordered_map<std::string_view, const Bus*>& GetAllRoutes() const;
@@ -41,9 +216,47 @@ public:
     const std::unordered_map<std::string_view, const Stop*> GetAllStops() const;
 
     // получение расстояния между двумя остановками
+    size_t GetDistanceBetweenStops(StopId from, StopId to) const;
     size_t GetDistanceBetweenStops(const Stop* from, const Stop* to) const;
 
+    // не более count ближайших к point остановок в пределах radius метров по возрастанию расстояния;
+    // пространственный индекс строится при заморозке
+    std::vector<NearbyStop> GetNearestStops(geo::Coordinates point, size_t count, double radius) const;
+
+    // остановки внутри прямоугольника координат [min, max], упорядоченные по названию
+    std::vector<const Stop*> GetStopsInBox(geo::Coordinates min, geo::Coordinates max) const;
+
+    // не более limit остановок, название которых начинается со строки, отличающейся от query
+    // не более чем на max_distance символов; упорядочены по числу правок, затем по названию
+    std::vector<const Stop*> SearchStops(std::string_view query, size_t max_distance, size_t limit) const;
+
+    // приблизительный объём собственной памяти в байтах; данные, подключённые через Attach, не учитываются
+    size_t GetMemoryUsage() const;
+
 private:
+    // выбрасывает исключение при попытке изменить замороженный справочник
+    void AssertNotFrozen() const;
+    // выбрасывает исключение при обращении к данным, которые строятся при заморозке
+    void AssertFrozen() const;
+
+    // сохраняет маршрут и добавляет его в индекс, статистика не рассчитывается
+    Bus& InsertBus(const Bus& bus);
+    // добавляет маршрут в списки автобусов его остановок
+    void AddBusToStops(const Bus& bus);
+    // убирает маршрут из списков автобусов его остановок
+    void RemoveBusFromStops(const Bus& bus);
+    // строит индекс отрезков, если он ещё не построен
+    void BuildSegmentIndex();
+    // добавляет маршрут в индекс отрезков и убирает из него соответственно
+    void AddBusToSegments(const Bus& bus);
+    void RemoveBusFromSegments(const Bus& bus);
+    // сохраняет статистику маршрута (в ленивом режиме отмечает её рассчитанной)
+    void SetRouteInfo(BusId bus, const BusStats& stats);
+    // строит индексы для чтения и замораживает справочник
+    void BuildFrozenIndexes();
+    // строит совершенные хеш-функции названий; при неудаче оставляет поиск на хеш-таблицах
+    void BuildPerfectHash();
+
     // расчитывает и возвращает статистику маршрута
     BusStats CalcBusStatistics(const Bus& bus) const;
 
@@ -56,19 +269,57 @@ private:
     // возвращает фактическую дину всего маршрута
     size_t GetRouteLengthF(const Bus& bus) const;
 
-    // хранение информации об остановках и маршрутах соответственно
+    // названия остановок и маршрутов
+    StringArena names_;
+
+    // владелец памяти данных, подключённых через Attach
+    std::shared_ptr<const void> storage_;
+
+    // хранение информации об остановках и маршрутах соответственно, позиция элемента совпадает с его id
     std::deque<Stop> stops_;
     std::deque<Bus> buses_;
+    // остановки маршрутов, на которые указывают Bus::stops (пусто, если данные подключены через Attach)
+    std::deque<std::vector<StopId>> buses_stops_;
+    // координаты остановок на единичной сфере, индекс - id остановки
+    std::vector<SpherePoint> stops_points_;
 
     // индексы для поиска остановок и автобусов по их названиям соответственно
     std::unordered_map<std::string_view, const Stop*> find_stops_;
     std::unordered_map<std::string_view, const Bus*> find_buses_;
+    // те же индексы на совершенном хешировании: функция переводит название в ячейку, в ячейке - id;
+    // строятся при заморозке. Если построить их не удалось, поиск остаётся на хеш-таблицах выше.
+    // Если функции построены при заморозке или подключены через Attach, таблица find_stops_ пуста
+    PerfectHashFunction stops_hash_;
+    FrozenArray<StopId> stops_by_slot_;
+    PerfectHashFunction buses_hash_;
+    FrozenArray<BusId> buses_by_slot_;
+    bool has_perfect_hash_ = false;
 
-    // информация о маршрутах
-    std::unordered_map<const Bus*, BusStats> route_info_;
-    // информация об остановках (какие автобусы проходят через остановку)
-    std::unordered_map<const Stop*, std::set<std::string_view>> stops_info_;
+    StatsMode stats_mode_;
+    // информация о маршрутах, индекс - id маршрута; в ленивом режиме заполняется при первом
+    // запросе, флаг route_info_ready_[id] гарантирует однократный расчёт при запросах из разных потоков
+    mutable std::vector<BusStats> route_info_;
+    mutable std::deque<std::once_flag> route_info_ready_;
+    // готовая информация о маршрутах, подключённая через Attach
+    std::span<const BusStats> attached_route_info_;
+    // информация об остановках (какие автобусы проходят через остановку), индекс - id остановки;
+    // заполняется до заморозки, каждая строка отсортирована по названию маршрута
+    std::vector<std::vector<BusId>> stops_info_;
+    // та же информация после заморозки: единый массив id маршрутов, автобусы остановки id лежат
+    // в диапазоне [stop_buses_offsets_[id], stop_buses_offsets_[id + 1])
+    FrozenArray<BusId> stop_buses_;
+    FrozenArray<uint32_t> stop_buses_offsets_;
     // фактические расстояния между парами остановок
-    std::unordered_map<std::pair<const Stop*, const Stop*>, size_t, StopHasher> stops_distances_;	
+    RoadDistances stops_distances_;
+    // индекс отрезков: пара соседних остановок маршрута без учёта направления (см. SegmentKey) ->
+    // отсортированные id проезжающих по ней маршрутов; строится при первом изменении данных
+    std::unordered_map<uint64_t, std::vector<BusId>> segment_buses_;
+    bool has_segment_index_ = false;
+    // пространственный индекс остановок, строится при заморозке
+    SpatialIndex stops_index_;
+    // индекс для поиска остановок по началу названия, строится при заморозке
+    NameIndex stops_names_index_;
+
+    bool is_frozen_ = false;
 };
 }// namespace catalogue
\ No newline at end of file
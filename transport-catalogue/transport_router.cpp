@@ -1,29 +1,56 @@
 #include "transport_router.h"
 
-#include <iostream>
+#include <stdexcept>
 
 using namespace graph;
 
 namespace router {
 
 TransportRouter::TransportRouter(RoutingSettings routing_settings,
-                                          const catalogue::TransportCatalogue& catalogue)
+                                 const catalogue::TransportCatalogue& catalogue,
+                                 const std::optional<RouterData>& data)
         : routing_settings_{routing_settings},
-          graph_{BuildGraph(catalogue)},
-          router_{graph_} {
+          catalogue_{catalogue},
+          graph_{data ? DirectedWeightedGraph<TravelTime>(data->graph) : BuildGraph(catalogue)},
+          router_{data ? Router<TravelTime>(graph_, data->routes) : Router<TravelTime>(graph_)} {
+    if(data) {
+        CheckRouteIds();
+    }
+}
+
+RouterData TransportRouter::GetData() const {
+    return {graph_.GetData(), router_.GetRoutes()};
+}
+
+// проверяет, что рёбра готового графа ссылаются на существующие остановки и маршруты
+void TransportRouter::CheckRouteIds() const {
+    for(EdgeId id = 0; id < graph_.GetEdgeCount(); ++id) {
+        const auto& edge = graph_.GetEdge(id);
+        const size_t count = edge.span_count ? catalogue_.GetBusesCount() : catalogue_.GetStopsCount();
+        if(edge.route_id >= count) {
+            throw std::runtime_error("Unknown route in router graph");
+        }
+    }
+}
+
+size_t TransportRouter::GetMemoryUsage() const {
+    return graph_.GetMemoryUsage() + router_.GetMemoryUsage();
+}
+
+// возвращает вершину ожидания на остановке, следующая за ней вершина - начало пути от остановки
+VertexId TransportRouter::GetWaitVertex(domain::StopId stop) {
+    return static_cast<VertexId>(stop) * 2;
 }
 
-// добавляет в переданный в качестве аргумента граф рёбра, которые отвечают за ожидание на остановках, и заполняет vertex_id_
+// добавляет в переданный в качестве аргумента граф рёбра, которые отвечают за ожидание на остановках
 void TransportRouter::AddWaitingEdges(DirectedWeightedGraph<TravelTime>& graph, const catalogue::TransportCatalogue& catalogue) {
-    VertexId id = 0;
-    for(const auto [name, ptr_stop] : catalogue.GetAllStops()) {
-        vertexes_ids_[ptr_stop] = id;
-        graph.AddEdge(Edge<TravelTime>{.route_id = name,
+    for(domain::StopId stop = 0; stop < catalogue.GetStopsCount(); ++stop) {
+        VertexId id = GetWaitVertex(stop);
+        graph.AddEdge(Edge<TravelTime>{.route_id = stop,
+                                       .span_count = 0,
                                        .from = id,
-                                       .to = ++id,
-                                       .weight = static_cast<TravelTime>(routing_settings_.bus_waiting_time),
-                                       .span_count = 0});
-        ++id;
+                                       .to = id + 1,
+                                       .weight = static_cast<TravelTime>(routing_settings_.bus_waiting_time)});
     }
 }
 
@@ -31,6 +58,7 @@ void TransportRouter::AddWaitingEdges(DirectedWeightedGraph<TravelTime>& graph,
 void TransportRouter::AddTransitEdges(DirectedWeightedGraph<TravelTime>& graph, const catalogue::TransportCatalogue& catalogue) {
     const auto& buses = catalogue.GetAllRoutes();
     for(const auto& [bus_name, ptr_bus] : buses) {
+        // хранится только прямой путь, рёбра обратного пути некольцевого маршрута добавляются ниже
         const auto& stops = ptr_bus->stops;
         size_t stops_count = stops.size();
         for(int i = 0; i < stops_count; ++i) {
@@ -44,19 +72,19 @@ void TransportRouter::AddTransitEdges(DirectedWeightedGraph<TravelTime>& graph,
 
                 TravelTime travel_time = dist / routing_settings_.bus_velocity;
                 // ребра для прямого пути из вершины остановки i в j
-                graph.AddEdge(Edge<TravelTime>{.route_id = bus_name,
-                                               .from = vertexes_ids_[stops[i]] + 1,
-                                               .to = vertexes_ids_[stops[j]],
-                                               .weight = travel_time,
-                                               .span_count = j - i});
+                graph.AddEdge(Edge<TravelTime>{.route_id = ptr_bus->id,
+                                               .span_count = j - i,
+                                               .from = GetWaitVertex(stops[i]) + 1,
+                                               .to = GetWaitVertex(stops[j]),
+                                               .weight = travel_time});
                 if(!ptr_bus->is_roundtrip) {
                     travel_time = reverse_dist / routing_settings_.bus_velocity;
                     // ребра для обратного пути из вершины остановки j в i
-                    graph.AddEdge(Edge<TravelTime>{.route_id = bus_name,
-                                                  .from = vertexes_ids_[stops[j]] + 1,
-                                                  .to = vertexes_ids_[stops[i]],
-                                                  .weight = travel_time,
-                                                  .span_count = j - i});
+                    graph.AddEdge(Edge<TravelTime>{.route_id = ptr_bus->id,
+                                                  .span_count = j - i,
+                                                  .from = GetWaitVertex(stops[j]) + 1,
+                                                  .to = GetWaitVertex(stops[i]),
+                                                  .weight = travel_time});
                 }
             }
         }
@@ -65,14 +93,15 @@ void TransportRouter::AddTransitEdges(DirectedWeightedGraph<TravelTime>& graph,
 
 graph::DirectedWeightedGraph<TravelTime> TransportRouter::BuildGraph(const catalogue::TransportCatalogue& catalogue) {
     // конструируем граф, на каждую остановку по две вершины: первая для ожидания, вторая - для начала пути
-    DirectedWeightedGraph<TravelTime> graph(catalogue.GetAllStops().size() * 2);
+    DirectedWeightedGraph<TravelTime> graph(catalogue.GetStopsCount() * 2);
     AddWaitingEdges(graph, catalogue);
     AddTransitEdges(graph, catalogue);
+    graph.Compact();
     return graph;
 }
 
 std::optional<ResultRoute> TransportRouter::BuildRoute(const domain::Stop* from, const domain::Stop* to) const {
-    const auto route = router_.BuildRoute(vertexes_ids_.at(from), vertexes_ids_.at(to));
+    const auto route = router_.BuildRoute(GetWaitVertex(from->id), GetWaitVertex(to->id));
     if(!route) {
         return std::nullopt;
     }
@@ -83,9 +112,10 @@ std::optional<ResultRoute> TransportRouter::BuildRoute(const domain::Stop* from,
     for(EdgeId edge_id : route->edges) {
         const auto& edge = graph_.GetEdge(edge_id);
         if(!edge.span_count) {
-            result_route.route_parts.push_back(WaitingPart{edge.route_id, edge.weight});
+            result_route.route_parts.push_back(WaitingPart{catalogue_.GetStopById(edge.route_id)->name, edge.weight});
         } else {
-            result_route.route_parts.push_back(TransitPart{edge.route_id, edge.weight, edge.span_count});
+            result_route.route_parts.push_back(
+                TransitPart{catalogue_.GetBusById(edge.route_id)->name, edge.weight, edge.span_count});
         }
     }
     return result_route;
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <optional>
+#include <span>
 #include <variant>
 
 #include "graph.h"
@@ -40,23 +42,46 @@ struct RoutingSettings {
     int bus_waiting_time;
 };
 
+// упакованные граф и таблица кратчайших путей маршрутизатора, например из файла снимка
+struct RouterData {
+    graph::DirectedWeightedGraph<TravelTime>::Data graph;
+    std::span<const graph::Router<TravelTime>::RouteInternalData> routes;
+};
+
 class TransportRouter {
 public:
-    explicit TransportRouter(RoutingSettings routing_settings, const catalogue::TransportCatalogue& catalogue);
+    // строит граф по справочнику и таблицу кратчайших путей; если задан data, использует готовые
+    // граф и таблицу из чужой памяти, которая должна жить дольше маршрутизатора
+    // (при несогласованных данных выбрасывает std::runtime_error)
+    TransportRouter(RoutingSettings routing_settings, const catalogue::TransportCatalogue& catalogue,
+                    const std::optional<RouterData>& data = std::nullopt);
+    // маршрутизатор хранит ссылку на свой граф, поэтому не копируется и не перемещается
+    TransportRouter(const TransportRouter&) = delete;
+    TransportRouter& operator=(const TransportRouter&) = delete;
+
     // построить маршрут
     std::optional<ResultRoute> BuildRoute(const domain::Stop* from, const domain::Stop* to) const;
+    // граф и таблица кратчайших путей в упакованном виде
+    RouterData GetData() const;
+    // приблизительный объём занятой памяти в байтах: граф и таблица кратчайших путей
+    size_t GetMemoryUsage() const;
 
 private:
     graph::DirectedWeightedGraph<TravelTime> BuildGraph(const catalogue::TransportCatalogue& catalogue);
-    // добавляет в переданный в качестве аргумента граф рёбра, которые отвечают за ожидание на остановках, и заполняет vertex_id_
+    // проверяет, что рёбра готового графа ссылаются на существующие остановки и маршруты
+    void CheckRouteIds() const;
+    // добавляет в переданный в качестве аргумента граф рёбра, которые отвечают за ожидание на остановках
     void AddWaitingEdges(graph::DirectedWeightedGraph<TravelTime>& graph, const catalogue::TransportCatalogue& catalogue);
 
     // добавляет в переданный в качестве аргумента граф рёбра, которые отвечают за проезд на автобусе между остановками
     void AddTransitEdges(graph::DirectedWeightedGraph<TravelTime>& graph, const catalogue::TransportCatalogue& catalogue);
     
+    // возвращает вершину ожидания на остановке, следующая за ней вершина - начало пути от остановки
+    static graph::VertexId GetWaitVertex(domain::StopId stop);
+
     RoutingSettings routing_settings_;
-    // индекс для поиска идентификаторов вершин по указателям на остановки
-    std::unordered_map<const domain::Stop*, graph::VertexId> vertexes_ids_;
+    // названия остановок и маршрутов рёбер берутся из справочника по id
+    const catalogue::TransportCatalogue& catalogue_;
 
     graph::DirectedWeightedGraph<TravelTime> graph_;
     graph::Router<TravelTime> router_;